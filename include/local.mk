@@ -71,6 +71,10 @@ dist_object_include_HEADERS =                   \
   include/urbi/object/list.hxx                  \
   include/urbi/object/lobby.hh                  \
   include/urbi/object/lobby.hxx                 \
+  include/urbi/object/local-slots.hh            \
+  include/urbi/object/local-slots.hxx           \
+  include/urbi/object/lookup-cache.hh           \
+  include/urbi/object/lookup-cache.hxx          \
   include/urbi/object/location.hh               \
   include/urbi/object/location.hxx              \
   include/urbi/object/matrix.hh                 \
@@ -130,6 +134,10 @@ EXTRA_DIST += $(FROM_GEN:=.gen)
 nodist_object_include_HEADERS = 		\
   $(precompiled_symbols_hh)
 
+# The storage of the slots, from configure (--enable-slots).
+nodist_object_include_HEADERS +=		\
+  include/urbi/object/slots-storage.hh
+
 # Generate this file in builddir so that a single srcdir can produce
 # several builddirs with different configuration-options that may
 # result in different sets of precompiled symbols.
@@ -15,10 +15,14 @@
 # define KERNEL_UCONNECTION_HH
 
 # include <libport/cstring>
+# include <deque>
 # include <iomanip>
 # include <memory>
 
+# include <boost/shared_ptr.hpp>
+
 # include <libport/config.h>
+# include <libport/utime.hh>
 
 # if LIBPORT_HAVE_WINDOWS_H
 // Without this, windows.h may include winsock.h, which will conflict with
@@ -153,6 +157,17 @@ namespace kernel
 
     void flush();
 
+    /// Flush the sending queue at the end of the current cycle of the
+    /// server, so that the messages of a cycle are sent in a single
+    /// write.  Flush now if the oldest message not flushed is older
+    /// than URBI_SEND_LATENCY microseconds (default 10ms, 0 to always
+    /// flush now), or if there are too many bytes pending.
+    void defer_flush();
+
+    /// Flush the sending queue if defer_flush() was called since the
+    /// last flush.  Called by the server at the end of each cycle.
+    void flush_deferred();
+
     /*------------.
     | Accessors.  |
     `------------*/
@@ -193,6 +208,11 @@ namespace kernel
     virtual void send_queue(const char* buffer, size_t length);
     /// Bounce to (const char* buffer, size_t length).
     void send_queue(const std::string& s);
+    /// Pile \a data in the sending queue without copying it: it is
+    /// kept until it is sent, see effective_send_shared().  Meant for
+    /// large buffers (binaries) sent to several connections.  Redefine
+    /// it along with send_queue(const char*, size_t).
+    virtual void send_queue(const boost::shared_ptr<const std::string>& data);
 
     /// Whether an interactive session.
     bool interactive_p() const;
@@ -217,6 +237,15 @@ namespace kernel
      */
     virtual size_t effective_send(const char*, size_t length) = 0;
 
+    /// Send \a length bytes of \a data from \a offset.  By default,
+    /// bounce to effective_send(const char*, size_t).  Redefine it if
+    /// the real connection can keep \a data until it is sent, instead
+    /// of copying it.
+    /// \return  the number of bytes effectively sent.
+    virtual size_t
+    effective_send_shared(const boost::shared_ptr<const std::string>& data,
+                          size_t offset, size_t length);
+
   public:
     /// Error return code for the constructor.
     UErrorValue uerror_;
@@ -241,12 +270,31 @@ namespace kernel
     typedef libport::Fifo<char, '\0'> queue_type;
     std::auto_ptr<queue_type> send_queue_;
 
+    /// A buffer piled in the sending queue without being copied.
+    struct shared_segment
+    {
+      /// The number of bytes pushed in send_queue_ before it.
+      size_t position;
+      boost::shared_ptr<const std::string> data;
+      /// The number of bytes of data already sent.
+      size_t sent;
+    };
+    /// The shared buffers, in order.
+    std::deque<shared_segment> shared_segments_;
+    /// The number of bytes popped from send_queue_.
+    size_t popped_;
+
     /// Each call to effective_send() will send packetSize byte (or less).
     size_t packet_size_;
 
     /// The state of the connection.
     bool blocked_;
 
+    /// Whether a flush was deferred to the end of the cycle.
+    bool flush_deferred_;
+    /// When the first message not flushed was queued.
+    libport::utime_t deferred_since_;
+
     /// True when the connection is reading to send/receive data (usualy
     /// set at "true" on start).
     bool active_;
@@ -263,6 +311,9 @@ namespace kernel
     size_t bytes_received_;
 
   private:
+    /// Queue the header of a message, "[TIME:TAG] ".
+    void send_header_(const char* tag);
+
     /// The received data stream.
     urbi::StreamBuffer stream_buffer_;
     std::istream stream_;
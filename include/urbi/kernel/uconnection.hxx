@@ -76,10 +76,19 @@ namespace kernel
   void
   UConnection::flush()
   {
+    flush_deferred_ = false;
     if (!blocked_)
       continue_send();
   }
 
+  inline
+  void
+  UConnection::flush_deferred()
+  {
+    if (flush_deferred_)
+      flush();
+  }
+
   inline
   void
   UConnection::received(const std::string& s)
@@ -276,6 +276,8 @@ namespace kernel
     /// killall order
     void work_handle_stopall_();
     void work_test_cpuoverload_();
+    /// Send the messages queued during the cycle by the connections.
+    void work_flush_connections_();
     /// \}
 
   public:
@@ -197,6 +197,46 @@ namespace urbi
 
       rHash hash() const;
 
+    /*--------------------.
+    | Unboxed operators.  |
+    `--------------------*/
+
+    public:
+      /// The binary operators the evaluator may compute directly on
+      /// the values of its operands, without calling the primitive.
+      enum unboxed_type
+      {
+        unboxed_plus,
+        unboxed_minus,
+        unboxed_star,
+        unboxed_slash,
+        unboxed_lt,
+        unboxed_lt_eq,
+        unboxed_gt,
+        unboxed_gt_eq,
+        unboxed_eq_eq,
+        unboxed_bang_eq,
+        unboxed_size,
+        unboxed_none = unboxed_size
+      };
+
+      /// The unboxed operator implemented by \a routine, or
+      /// unboxed_none if \a routine is not one of the primitives
+      /// bound on Float.
+      static unboxed_type unboxed_operator(const Object* routine);
+
+      /// Apply \a op on \a lhs and \a rhs.  Comparisons return the
+      /// shared true and false objects, so only arithmetics allocate.
+      /// Return 0 if the primitive must be called instead, i.e., when
+      /// it would raise.
+      static rObject unboxed_apply(unboxed_type op,
+                                   value_type lhs, value_type rhs);
+
+    private:
+      /// The primitives of Float::proto, indexed by unboxed_type.  Kept
+      /// alive so that their addresses are never reused.
+      static rObject unboxed_[unboxed_size];
+
 
     /*----------.
     | Details.  |
@@ -67,6 +67,15 @@ namespace urbi
       return std::numeric_limits<libport::ufloat>::quiet_NaN();
     }
 
+    inline
+    Float::unboxed_type
+    Float::unboxed_operator(const Object* routine)
+    {
+      for (unsigned i = 0; i < unboxed_size; ++i)
+        if (unboxed_[i].get() == routine)
+          return static_cast<unboxed_type>(i);
+      return unboxed_none;
+    }
 
   } // namespace object
 }
@@ -90,6 +90,8 @@ namespace urbi
     class Slot;
     typedef libport::intrusive_ptr<Slot> rSlot;
 
+    class LookupCache;
+
 # define FWD_DECL(Class)                                \
     class Class;                                        \
     typedef libport::intrusive_ptr<Class> r ## Class    \
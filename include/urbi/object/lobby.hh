@@ -47,6 +47,10 @@ namespace urbi
 
       void send(const std::string& data);
       void send(const std::string& data, const std::string& tag);
+      /// Send the Binary made of \a keywords and \a data, as
+      /// send(Binary.asString, tag) would, but without copying \a data.
+      void send_binary(const std::string& keywords, rString data,
+                       const std::string& tag);
       void write(const std::string& data);
       connection_type& connection_get();
       const connection_type& connection_get() const;
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+#ifndef OBJECT_LOCAL_SLOTS_HH
+# define OBJECT_LOCAL_SLOTS_HH
+
+# include <utility>
+# include <vector>
+
+# include <libport/hash.hh>
+# include <libport/symbol.hh>
+
+# include <urbi/object/fwd.hh>
+
+namespace urbi
+{
+  namespace object
+  {
+    /// Slots stored in their owner.
+    ///
+    /// Same interface as CentralizedSlots, but each object holds its
+    /// own table: up to index_threshold slots are stored inline, in
+    /// the object, and scanned linearly; above that, they move to a
+    /// vector on the heap, completed by a hash index.
+    ///
+    /// Adding or removing a slot invalidates the iterators.
+    class URBI_SDK_API LocalSlots
+    {
+
+      /*---------------.
+      | Type aliases.  |
+      `---------------*/
+
+    public:
+      LocalSlots();
+      /// Slots are not copied along with their owner.
+      LocalSlots(const LocalSlots&);
+      LocalSlots& operator=(const LocalSlots&);
+      ~LocalSlots();
+
+      /// The slot type
+      typedef rObject value_type;
+      /// The key type
+      typedef libport::Symbol key_type;
+      /// The location of a slot
+      typedef std::pair<Object*, libport::Symbol> location_type;
+      /// A slot and its location
+      typedef std::pair<location_type, value_type> q_slot_type;
+
+    private:
+      /// The slots of the objects with many slots, in order of
+      /// creation, and their position.
+      struct Large
+      {
+        std::vector<q_slot_type> content;
+        boost::unordered_map<key_type, unsigned> index;
+      };
+
+    public:
+      /// The iterator type
+      typedef q_slot_type* iterator;
+      /// The const iterator type
+      typedef const q_slot_type* const_iterator;
+
+      /// Number of slots stored inline, above which the hash index is
+      /// used.
+      static const unsigned index_threshold = 8;
+
+
+      /*------.
+      | API.  |
+      `------*/
+
+    public:
+      /// Get a begin iterator.
+      static iterator begin(Object* owner);
+      /// Get a begin const iterator.
+      static const_iterator begin(const Object* owner);
+      /// Dispose of the slots of \a owner.
+      static void finalize(Object* owner);
+      /// Get a past-the-end iterator.
+      static iterator end(Object* owner);
+      /// Get a past-the-end cosnt iterator.
+      static const_iterator end(const Object* owner);
+      /// Erase \a owner's \a key slot.
+      /// @return Success status.
+      ///         I.e., false if the slot was not defined (entailing failure).
+      static bool erase(Object* owner, const key_type& key);
+      /// Get \a owner's \a key slot's value.
+      static value_type get(const Object* owner, const key_type& key);
+      /// Return whether \a owner has a \a key slot.
+      static bool has(Object* owner, const key_type& key);
+
+      /// Set \a owner's \a key slot's value to \a v.
+      /// @return Success status.
+      ///         (false iff the slot was already defined (entailing failure)).
+      static bool
+      set(Object* owner, const key_type& key, value_type v,
+          bool overwrite = false);
+
+
+      /*----------.
+      | Helpers.  |
+      `----------*/
+
+    private:
+      /// The first slot.
+      q_slot_type* data();
+      const q_slot_type* data() const;
+      /// The number of slots.
+      unsigned size() const;
+      /// The position of \a key, or -1.
+      int where(const key_type& key) const;
+      /// Move the inline slots to large_.
+      void grow();
+      /// Move the slots of large_ back inline.
+      void shrink();
+
+
+      /*----------.
+      | Members.  |
+      `----------*/
+
+    private:
+      /// The slots, while there are at most index_threshold of them.
+      q_slot_type inline_[index_threshold];
+      /// The number of inline slots.
+      unsigned size_;
+      /// The slots once there are more, 0 before.
+      Large* large_;
+    };
+  }
+}
+
+#endif
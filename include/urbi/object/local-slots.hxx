@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+#ifndef OBJECT_LOCAL_SLOTS_HXX
+# define OBJECT_LOCAL_SLOTS_HXX
+
+# include <algorithm>
+
+# include <urbi/object/object.hh>
+
+namespace urbi
+{
+  namespace object
+  {
+
+    inline LocalSlots::iterator
+    LocalSlots::begin(Object* owner)
+    {
+      return owner->slots_.data();
+    }
+
+    inline LocalSlots::const_iterator
+    LocalSlots::begin(const Object* owner)
+    {
+      return owner->slots_.data();
+    }
+
+    inline void
+    LocalSlots::finalize(Object* owner)
+    {
+      LocalSlots& s = owner->slots_;
+      for (unsigned i = 0; i < s.size_; ++i)
+        s.inline_[i] = q_slot_type();
+      s.size_ = 0;
+      delete s.large_;
+      s.large_ = 0;
+    }
+
+    inline LocalSlots::iterator
+    LocalSlots::end(Object* owner)
+    {
+      return owner->slots_.data() + owner->slots_.size();
+    }
+
+    inline LocalSlots::const_iterator
+    LocalSlots::end(const Object* owner)
+    {
+      return owner->slots_.data() + owner->slots_.size();
+    }
+
+    inline bool
+    LocalSlots::set(Object* owner,
+                    const key_type& key, value_type v, bool overwrite)
+    {
+      LocalSlots& s = owner->slots_;
+      int i = s.where(key);
+      if (i != -1)
+      {
+        if (!overwrite)
+          return false;
+        s.data()[i].second = v;
+        return true;
+      }
+      q_slot_type slot(location_type(owner, key), v);
+      if (!s.large_ && s.size_ < index_threshold)
+      {
+        s.inline_[s.size_++] = slot;
+        return true;
+      }
+      if (!s.large_)
+        s.grow();
+      s.large_->index[key] = s.large_->content.size();
+      s.large_->content.push_back(slot);
+      return true;
+    }
+
+    inline LocalSlots::value_type
+    LocalSlots::get(const Object* owner, const key_type& key)
+    {
+      const LocalSlots& s = owner->slots_;
+      int i = s.where(key);
+      if (i == -1)
+        return 0;
+      return s.data()[i].second;
+    }
+
+    inline bool
+    LocalSlots::erase(Object* owner, const key_type& key)
+    {
+      LocalSlots& s = owner->slots_;
+      int i = s.where(key);
+      if (i == -1)
+        return false;
+      if (!s.large_)
+      {
+        std::copy(s.inline_ + i + 1, s.inline_ + s.size_, s.inline_ + i);
+        s.inline_[--s.size_] = q_slot_type();
+        return true;
+      }
+      Large& l = *s.large_;
+      l.content.erase(l.content.begin() + i);
+      if (l.content.size() <= index_threshold)
+      {
+        s.shrink();
+        return true;
+      }
+      l.index.erase(key);
+      // The slots after i moved down by one.
+      for (unsigned j = i; j < l.content.size(); ++j)
+        --l.index[l.content[j].first.second];
+      return true;
+    }
+
+    inline bool
+    LocalSlots::has(Object* owner, const key_type& key)
+    {
+      return owner->slots_.where(key) != -1;
+    }
+
+    inline LocalSlots::q_slot_type*
+    LocalSlots::data()
+    {
+      return large_ ? &large_->content[0] : inline_;
+    }
+
+    inline const LocalSlots::q_slot_type*
+    LocalSlots::data() const
+    {
+      return large_ ? &large_->content[0] : inline_;
+    }
+
+    inline unsigned
+    LocalSlots::size() const
+    {
+      return large_ ? large_->content.size() : size_;
+    }
+
+    inline int
+    LocalSlots::where(const key_type& key) const
+    {
+      if (large_)
+      {
+        boost::unordered_map<key_type, unsigned>::const_iterator i =
+          large_->index.find(key);
+        return i == large_->index.end() ? -1 : int(i->second);
+      }
+      for (unsigned i = 0; i < size_; ++i)
+        if (inline_[i].first.second == key)
+          return i;
+      return -1;
+    }
+
+    inline void
+    LocalSlots::grow()
+    {
+      large_ = new Large;
+      large_->content.reserve(2 * index_threshold);
+      for (unsigned i = 0; i < size_; ++i)
+      {
+        large_->index[inline_[i].first.second] = i;
+        large_->content.push_back(inline_[i]);
+        inline_[i] = q_slot_type();
+      }
+      size_ = 0;
+    }
+
+    inline void
+    LocalSlots::shrink()
+    {
+      size_ = large_->content.size();
+      std::copy(large_->content.begin(), large_->content.end(), inline_);
+      delete large_;
+      large_ = 0;
+    }
+
+  }
+}
+
+#endif
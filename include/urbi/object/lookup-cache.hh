@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file urbi/object/lookup-cache.hh
+ ** \brief Definition of object::LookupCache.
+ */
+
+#ifndef OBJECT_LOOKUP_CACHE_HH
+# define OBJECT_LOOKUP_CACHE_HH
+
+# include <utility>
+
+# include <libport/symbol.hh>
+
+# include <urbi/object/fwd.hh>
+
+namespace urbi
+{
+  namespace object
+  {
+    /// Polymorphic inline cache for the slot lookups of a call site.
+    ///
+    /// An entry remembers the result of a lookup on a given receiver.
+    /// It remains valid as long as neither the receiver nor any of the
+    /// objects used as protos changed their layout (see
+    /// Object::shape_version_get and Object::protos_version_get).
+    class URBI_SDK_API LookupCache
+    {
+    public:
+      /// Same as Object::location_type.
+      typedef std::pair<Object*, rObject> location_type;
+
+      LookupCache();
+
+      /// Same as \a tgt->slot_locate(k, fallback), but skip the walk
+      /// in the protos if a previous lookup is still valid.
+      location_type
+      slot_locate(const Object* tgt, libport::Symbol k, bool fallback);
+
+      /// Number of lookups served by the caches.
+      static unsigned long hits;
+      /// Number of lookups that required a walk in the protos.
+      static unsigned long misses;
+      /// Reset the hits and misses counters.
+      static void stats_reset();
+
+    private:
+      /// Perform the lookup, and store it if possible.
+      location_type
+      miss_(const Object* tgt, libport::Symbol k, bool fallback);
+
+      struct Entry
+      {
+        /// The receiver of the lookup.  Never dereferenced: an entry
+        /// is used only if the version below still matches.
+        const Object* receiver;
+        libport::Symbol name;
+        bool fallback;
+        /// The receiver's shape version at the time of the lookup.
+        unsigned long shape_version;
+        /// The protos version at the time of the lookup.
+        unsigned long protos_version;
+        /// The result of the lookup.  Kept alive by the owner as long
+        /// as the versions match.
+        Object* owner;
+        Object* value;
+      };
+
+      /// Number of receivers remembered per call site.
+      static const unsigned size = 4;
+      Entry entries_[size];
+      /// Next entry to replace.
+      unsigned next_;
+    };
+  }
+}
+
+#endif // !OBJECT_LOOKUP_CACHE_HH
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file urbi/object/lookup-cache.hxx
+ ** \brief Inline implementation of object::LookupCache.
+ */
+
+#ifndef OBJECT_LOOKUP_CACHE_HXX
+# define OBJECT_LOOKUP_CACHE_HXX
+
+# include <urbi/object/lookup-cache.hh>
+# include <urbi/object/object.hh>
+
+namespace urbi
+{
+  namespace object
+  {
+    inline LookupCache::location_type
+    LookupCache::slot_locate(const Object* tgt, libport::Symbol k,
+                             bool fallback)
+    {
+      for (unsigned i = 0; i < size; ++i)
+      {
+        const Entry& e = entries_[i];
+        if (e.receiver == tgt
+            && e.name == k
+            && e.fallback == fallback
+            && e.shape_version == tgt->shape_version_
+            && e.protos_version == Object::protos_version_)
+        {
+          ++hits;
+          return location_type(e.owner, e.value);
+        }
+      }
+      return miss_(tgt, k, fallback);
+    }
+  }
+}
+
+#endif // !OBJECT_LOOKUP_CACHE_HXX
@@ -31,6 +31,8 @@
 
 # include <urbi/object/fwd.hh>
 # include <urbi/object/centralized-slots.hh>
+# include <urbi/object/local-slots.hh>
+# include <urbi/object/slots-storage.hh>
 # include <urbi/export.hh>
 
 # define URBI_ATTRIBUTE_ON_DEMAND_DECLARE(Type, Name)   \
@@ -80,8 +82,13 @@ namespace urbi
       virtual ~Object();
       /// \}
 
-      /// The slots implementation
+      /// The slots implementation, chosen at configuration time
+      /// (see urbi/object/slots-storage.hh).
+# if URBI_CENTRALIZED_SLOTS
       typedef CentralizedSlots slots_implem;
+# else
+      typedef LocalSlots slots_implem;
+# endif
 
       /// Type of the keys.
       typedef slots_implem::key_type key_type;
@@ -243,6 +250,19 @@ namespace urbi
 
       /// \}
 
+      /// \name Lookup caches.
+      /// \{
+      /// The version of the layout (slots and protos) of this object.
+      /// It changes whenever a slot is added, replaced or removed, or
+      /// whenever the protos change.  Versions are never reused, even
+      /// by different objects.
+      unsigned long shape_version_get() const;
+
+      /// The version shared by all the objects used as protos.  It
+      /// changes whenever the layout of one of them changes.
+      static unsigned long protos_version_get();
+      /// \}
+
       /// \name Properties.
       /// \{
       /// Return the dictionary of the properties.
@@ -272,7 +292,7 @@ namespace urbi
       std::ostream& id_dump(std::ostream& o) const;
       /// Report a slot and possibly its properties.
       std::ostream& slot_dump(std::ostream& o,
-                              const CentralizedSlots::q_slot_type& s,
+                              const slots_implem::q_slot_type& s,
                               int depth_max) const;
 
       /// Dump the special slots if there are.
@@ -419,6 +439,12 @@ namespace urbi
 
       location_type slot_locate_(key_type k) const;
 
+      /// Record a change in the layout of this object.
+      void shape_changed_();
+
+      /// Set slot \a k to \a v, even if it already exists.
+      void slot_overwrite_(key_type k, const rObject& v);
+
       /// Our proto as long as we only have one, ie protos_ = 0.
       rObject proto_;
 
@@ -433,11 +459,29 @@ namespace urbi
 
       mutable int lookup_id_;
 
+      /// See shape_version_get().
+      unsigned long shape_version_;
+
+      /// Whether this object is (or was) a proto of another object.
+      bool is_proto_;
+
+      /// Source of fresh shape versions.
+      static unsigned long shape_version_counter_;
+
+      /// See protos_version_get().
+      static unsigned long protos_version_;
+
+      /// Set by slot_locate_ when the lookup went through protos
+      /// exposed to Urbi, which can be changed behind our back.
+      static bool lookup_volatile_;
+
     public:
       typedef boost::unordered_set<rObject> objects_set_type;
       template<class F> friend bool
       for_all_protos(const rObject& r, F& f, objects_set_type& objects);
       friend class CentralizedSlots;
+      friend class LocalSlots;
+      friend class LookupCache;
     };
 
     /// Call f(robj) on r and all its protos hierarchy, stop if it returns true.
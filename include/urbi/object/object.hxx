@@ -66,6 +66,8 @@ namespace urbi
     Object&
     Object::unsafe_proto_add(const rObject& v)
     {
+      v->is_proto_ = true;
+      shape_changed_();
       if (protos_)
         protos_->push_front(v);
       else
@@ -86,6 +88,7 @@ namespace urbi
     Object::proto_remove(const rObject& p)
     {
       aver(p);
+      shape_changed_();
       if (!protos_)
       {
         if (proto_ == p)
@@ -110,6 +113,7 @@ namespace urbi
     bool
     Object::slot_remove(key_type k)
     {
+      shape_changed_();
       return slots_.erase(this, k);
     }
 
@@ -121,6 +125,34 @@ namespace urbi
     }
 
 
+    /*----------------.
+    | Lookup caches.  |
+    `----------------*/
+
+    inline
+    unsigned long
+    Object::shape_version_get() const
+    {
+      return shape_version_;
+    }
+
+    inline
+    unsigned long
+    Object::protos_version_get()
+    {
+      return protos_version_;
+    }
+
+    inline
+    void
+    Object::shape_changed_()
+    {
+      shape_version_ = ++shape_version_counter_;
+      if (is_proto_)
+        protos_version_ = shape_version_;
+    }
+
+
     /*--------.
     | Clone.  |
     `--------*/
@@ -306,6 +306,7 @@
   Macro(enableStats, "enableStats");              \
   Macro(enabled, "enabled");                      \
   Macro(end, "end");                              \
+  Macro(engine, "engine");                        \
   Macro(enter, "enter");                          \
   Macro(enterEvent, "enterEvent");                \
   Macro(env, "env");                              \
@@ -550,8 +551,10 @@
   Macro(selfTime, "selfTime");                    \
   Macro(selfTimePer, "selfTimePer");              \
   Macro(send, "send");                            \
+  Macro(sendBinary, "sendBinary");                \
   Macro(sender, "sender");                        \
   Macro(seq, "seq");                              \
+  Macro(serializeMessage, "serializeMessage");    \
   Macro(set, "set");                              \
   Macro(setAutoRead, "setAutoRead");              \
   Macro(setConstSlotValue, "setConstSlotValue");  \
@@ -25,6 +25,7 @@
 # include <urbi/object/symbols.hh>
 # include <urbi/object/fwd.hh>
 # include <urbi/object/cxx-object.hh>
+# include <urbi/object/slots-storage.hh>
 
 namespace urbi
 {
@@ -217,6 +218,10 @@ namespace urbi
   }
 }
 
-# include <urbi/object/centralized-slots.hxx>
+# if URBI_CENTRALIZED_SLOTS
+#  include <urbi/object/centralized-slots.hxx>
+# else
+#  include <urbi/object/local-slots.hxx>
+# endif
 # include <urbi/object/cxx-object.hxx>
 #endif
@@ -16,6 +16,8 @@
 #ifndef OBJECT_STRING_HH
 # define OBJECT_STRING_HH
 
+# include <boost/shared_ptr.hpp>
+
 # include <libport/ufloat.hh>
 # include <urbi/object/cxx-object.hh>
 # include <urbi/object/equality-comparable.hh>
@@ -47,8 +49,17 @@ namespace urbi
       String(rString model);
       String(const value_type& value);
       const value_type& value_get() const;
+      /// Since the content may be changed, it is no longer shared.
+      /// Do not keep the reference across a call to shared_get.
       value_type& value_get();
 
+      /// The content, shared by those who need it to outlive the
+      /// changes of the String (e.g., the messages queued by the
+      /// connections, see UConnection::send_queue).  The buffer of the
+      /// String is moved there, not copied; it is copied back only if
+      /// the String changes while still shared.
+      boost::shared_ptr<const value_type> shared_get() const;
+
       // Comparison.
       bool operator<=(const value_type& rhs) const;
 
@@ -149,7 +160,12 @@ namespace urbi
       unsigned char toAscii() const;
 
     private:
-      value_type content_;
+      /// The content, unless it was given to shared_get.
+      mutable value_type content_;
+      /// The content once given to shared_get, until the String changes.
+      mutable boost::shared_ptr<value_type> shared_;
+      /// Get the content back into content_, before changing it.
+      void unshare_();
 
       /// Check that is a valid index, and return its value in bounds.
       /// \param large  Whether we accept idx == size().
@@ -15,6 +15,7 @@ urbiinclude_HEADERS =                           \
   include/urbi/details.hh                       \
   include/urbi/exit.hh                          \
   include/urbi/export.hh                        \
+  include/urbi/frame-pool.hh                    \
   include/urbi/fwd.hh                           \
   include/urbi/input-port.hh                    \
   include/urbi/input-port.hxx                   \
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file urbi/frame-pool.hh
+/// \brief Recycling of the buffers of the binaries.
+///
+/// Streams of images or sounds allocate buffers of the same few sizes
+/// again and again.  The frame pool keeps the released buffers, by
+/// size class, to serve the next requests without malloc.
+///
+/// The buffers are allocated with malloc: a buffer of the pool may be
+/// given to the user, who frees it with free, and any buffer
+/// allocated with malloc may be given back to the pool.
+
+#ifndef URBI_FRAME_POOL_HH
+# define URBI_FRAME_POOL_HH
+
+# include <cstddef>
+
+# include <urbi/export.hh>
+
+namespace urbi
+{
+  namespace frame_pool
+  {
+    /// A buffer of at least \a size bytes, allocated with malloc.
+    /// \param capacity  set to the size of the buffer, to give to
+    ///                  release.
+    URBI_SDK_API void* acquire(size_t size, size_t& capacity);
+
+    /// Keep \a data, a buffer of at least \a capacity bytes allocated
+    /// with malloc, for a later acquire.  Free it if the pool is full.
+    /// Does nothing if \a data is 0.
+    URBI_SDK_API void release(void* data, size_t capacity);
+
+    /// Free the buffers kept.
+    URBI_SDK_API void clear();
+
+    /// The number of bytes the kept buffers may total, beyond which
+    /// the released buffers are freed.  Defaults to 64MiB.
+    URBI_SDK_API size_t limit();
+    URBI_SDK_API void limit(size_t bytes);
+
+    /// Counters, to tune the limit.
+    struct URBI_SDK_API Stats
+    {
+      Stats();
+      /// The acquire served by a kept buffer.
+      size_t hits;
+      /// The acquire served by malloc.
+      size_t misses;
+      /// The buffers kept by release.
+      size_t releases;
+      /// The buffers freed by release, the pool being full.
+      size_t drops;
+      /// The buffers currently kept, and their total size.
+      size_t buffers;
+      size_t bytes;
+    };
+
+    /// The counters since the start, or the last reset.
+    URBI_SDK_API Stats stats();
+    /// Reset hits, misses, releases and drops.
+    URBI_SDK_API void reset_stats();
+  }
+}
+
+#endif // ! URBI_FRAME_POOL_HH
@@ -108,8 +108,8 @@ namespace urbi
     errors.
     - Redfine the four mutual exclusion functions.
     - Redefine effectiveSend().
-    - Fill recvBuffer, update recvBufferPosition and call processRecvBuffer()
-    when new data is available.
+    - Call recvData() when new data is available, or fill recvBuffer,
+    update recvBufferPosition and call processRecvBuffer().
     - Provide an execute() function in the namespace urbi, that never returns,
     and that will be called after initialization.
     - Call onConnection when the connection is established.
@@ -345,6 +345,12 @@ namespace urbi
     /// Called each time new data is available in recvBuffer.
     void processRecvBuffer();
 
+  protected:
+    /// Process the \a length bytes of \a data just received.  The
+    /// payload of the binaries is copied directly to its final
+    /// buffer, the rest is appended to recvBuffer.
+    void recvData(const char* data, size_t length);
+
   private:
     /// New binary data is available.
     /// \return true if there is still data to process.
@@ -419,6 +425,10 @@ namespace urbi
     char* recvBuffer;
     /// Current position in reception buffer.
     size_t recvBufferPosition;
+    /// Position of the first byte not processed yet in recvBuffer.
+    /// The messages are parsed in place: the buffer is compacted only
+    /// when room is needed.
+    size_t recvBufferStart;
     /// Temporary buffer for send data.
     char* sendBuffer;
 
@@ -475,15 +485,21 @@ namespace urbi
     size_t binaryBufferPosition;
     /// Size of binaryBuffer.
     size_t binaryBufferLength;
+    /// Capacity of binaryBuffer, from the frame pool.
+    size_t binaryBufferCapacity;
 
     /// Position of parse in recvBuffer.
     size_t parsePosition;
+    /// Make room for \a length more bytes in recvBuffer.
+    void recv_buffer_reserve_(size_t length);
+    /// Mark everything before \a pos in recvBuffer as processed.
+    void recv_buffer_consume_(size_t pos);
     /// True if preparsing is in a string.
     bool inString;
     /// Current depth of bracket.
     size_t nBracket;
-    /// Start of command, after [ts:tag] header.
-    char* currentCommand;
+    /// Position of the start of command, after [ts:tag] header.
+    size_t currentCommand;
 
     /// Currently parsing binary
     bool binaryMode;
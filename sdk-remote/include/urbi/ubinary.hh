@@ -18,6 +18,7 @@
 # include <string>
 
 # include <urbi/export.hh>
+# include <urbi/frame-pool.hh>
 # include <urbi/uimage.hh>
 # include <urbi/usound.hh>
 
@@ -33,11 +34,22 @@ namespace urbi
   {
   public:
     BinaryData();
-    BinaryData(void *d, size_t s);
+    /// \param o  whether \a d, allocated with malloc, can be taken
+    ///            by the parser instead of being copied.
+    /// \param c  if nonzero, \a d comes from the frame pool, with
+    ///            this capacity.
+    BinaryData(void *d, size_t s, bool o = false, size_t c = 0);
     /// Reclaim data.
     void clear();
-    void* data;
+    /// If data is owned, give it to the caller, who is now in charge
+    /// of freeing it, otherwise return 0.
+    void* release() const;
+    mutable void* data;
     size_t size;
+    mutable bool owned;
+    /// The capacity of data if it comes from the frame pool, 0
+    /// otherwise.
+    size_t capacity;
   };
 
   /// List of the binaries.
@@ -118,6 +130,16 @@ namespace urbi
      * some point.
      */
     bool temporary_;
+
+    /// The buffer allocated in the frame pool, and its capacity, given
+    /// back to the pool by clear() if it still is common.data.
+    void* pooled_;
+    size_t capacity_;
+
+  private:
+    /// Set common.data to a buffer of common.size bytes from the
+    /// frame pool.
+    void allocate_();
   };
 
   URBI_SDK_API
@@ -15,18 +15,32 @@ namespace urbi
 
   inline
   BinaryData::BinaryData()
-    : data(0), size(0)
+    : data(0), size(0), owned(false), capacity(0)
   {}
 
   inline
-  BinaryData::BinaryData(void *d, size_t s)
-    : data(d), size(s)
+  BinaryData::BinaryData(void *d, size_t s, bool o, size_t c)
+    : data(d), size(s), owned(o), capacity(c)
   {}
 
   inline
   void BinaryData::clear()
   {
-    free(data);
+    if (capacity)
+      frame_pool::release(data, capacity);
+    else
+      free(data);
+  }
+
+  inline
+  void* BinaryData::release() const
+  {
+    if (!owned)
+      return 0;
+    void* res = data;
+    data = 0;
+    owned = false;
+    return res;
   }
 
 } // end namespace urbi
@@ -13,12 +13,15 @@
 #ifndef URBI_UCALLBACKS_HH
 # define URBI_UCALLBACKS_HH
 
+# include <deque>
 # include <string>
 
 # include <libport/compiler.hh>
+# include <libport/lockable.hh>
 # include <libport/meta.hh>
 # include <libport/preproc.hh>
 # include <libport/thread-pool.hh>
+# include <libport/utime.hh>
 # include <urbi/export.hh>
 # include <urbi/fwd.hh>
 # include <urbi/utable.hh>
@@ -27,6 +30,7 @@
 # include <urbi/uvar.hh>
 
 # include <boost/function.hpp>
+# include <boost/shared_ptr.hpp>
 
 namespace urbi
 {
@@ -48,6 +52,19 @@ namespace urbi
     {}
   };
 
+  /// What a threaded callback does with a new call when its queue of
+  /// waiting calls is full.
+  enum OverflowPolicy
+  {
+    /// Drop the new call.
+    OVERFLOW_DROP_NEWEST,
+    /// Drop the oldest waiting call.
+    OVERFLOW_DROP_OLDEST,
+    /// Keep a single waiting call, the latest one, whatever the size
+    /// of the queue.
+    OVERFLOW_COALESCE
+  };
+
   //! Function and Event storage mechanism
   /// This heavily overloaded class is the only way in C++ to make
   /// life easy from the the interface user point's of view.  */
@@ -76,7 +93,31 @@ namespace urbi
     }
 
     /// Set this callback to asynchronous mode using \b mode locking mode.
-    void setAsync(libport::ThreadPool::rTaskLock lock);
+    /// If \a overflow is not OVERFLOW_DROP_NEWEST, the calls waiting
+    /// for the lock are queued by this callback, at most \a maxQueueSize
+    /// of them (0 for no limit), and \a lock must not drop calls.
+    void setAsync(libport::ThreadPool::rTaskLock lock,
+                  unsigned int maxQueueSize = 0,
+                  OverflowPolicy overflow = OVERFLOW_DROP_NEWEST);
+
+    /// Statistics about the calls of an asynchronous callback.
+    struct QueueStats
+    {
+      QueueStats()
+        : size(0), maxSize(0), dropped(0), started(0)
+        , latency(0), maxLatency(0)
+      {}
+      /// Number of calls waiting for a thread, and its maximum.
+      size_t size, maxSize;
+      /// Number of dropped calls.
+      size_t dropped;
+      /// Number of started calls, with their total and maximum
+      /// waiting time.
+      size_t started;
+      libport::utime_t latency, maxLatency;
+    };
+    /// The statistics since the creation of the callback.
+    QueueStats queueStats() const;
 
     typedef boost::function2<void, UValue&, const std::exception*> OnDone;
     /** Start evaluation, call onDone with result when done.
@@ -112,6 +153,33 @@ namespace urbi
     libport::ThreadPool::rTaskLock taskLock;
     /// True if call must be made synchronously.
     bool synchronous_;
+
+  private:
+    /// A call waiting for a thread.
+    struct Pending
+    {
+      boost::shared_ptr<UList> params;
+      OnDone onDone;
+      libport::utime_t date;
+    };
+    /// Queue a call in pending_, according to overflow_.
+    void queueEval(UList& params, OnDone onDone);
+    /// Run the first pending call, in a thread.
+    void runPending();
+    /// Run a call queued by the thread pool at \a date, in a thread.
+    void runTask(UList& params, OnDone onDone, libport::utime_t date);
+    /// Account for the start of a call queued at \a date, with
+    /// queueLock_ held.
+    void callStarted(libport::utime_t date);
+
+    /// Maximum size of pending_, 0 for no limit.
+    unsigned int maxQueueSize_;
+    OverflowPolicy overflow_;
+    /// The waiting calls, if they are queued by this callback.
+    std::deque<Pending> pending_;
+    QueueStats queueStats_;
+    /// Protects pending_ and queueStats_.
+    mutable libport::Lockable queueLock_;
     template<typename T>
     static inline impl::UContextImpl* fetchContext(T* ptr, libport::meta::True)
     {
@@ -145,5 +145,44 @@ namespace urbi
   /// JPEG compression not implemented.
   URBI_SDK_API int convert(const UImage& source, UImage& destination);
 
+  /// The filters to scale images.
+  enum UScaleFilter
+  {
+    SCALE_AUTO,      ///< SCALE_AREA to shrink, SCALE_BILINEAR to enlarge.
+    SCALE_BILINEAR,  ///< Interpolate between the two nearest pixels.
+    SCALE_AREA,      ///< Average the pixels covered (a.k.a. box filter).
+  };
+
+  /// How convert() runs.
+  struct URBI_SDK_API ConversionPolicy
+  {
+    /// Convert on \a threads threads, the calling one included.
+    explicit ConversionPolicy(size_t threads = 1, size_t band_rows = 16,
+                              UScaleFilter filter = SCALE_AUTO);
+
+    /// The number of threads.  The results do not depend on it.  With
+    /// 1, the default, everything is done in the calling thread, in a
+    /// deterministic order.
+    size_t threads;
+    /// The minimal number of rows of the bands the image is split in,
+    /// which are converted concurrently.
+    size_t band_rows;
+    /// The filter used to scale, on each axis.
+    UScaleFilter filter;
+    /// The quality of the JPEG images produced, from 0 to 100.
+    /// Defaults to 80.
+    int jpeg_quality;
+  };
+
+  /// Convert \a source to \a destination, as above, running
+  /// the color space conversion, the scaling and the packing of planar
+  /// formats on row bands as specified by \a policy.
+  ///
+  /// JPEG images are decoded at 1/2, 1/4 or 1/8 of their size when
+  /// the destination is that small, with libjpeg objects reused by
+  /// each thread.
+  URBI_SDK_API int convert(const UImage& source, UImage& destination,
+                           const ConversionPolicy& policy);
+
 } // namespace urbi
 #endif
@@ -20,6 +20,13 @@ namespace urbi
 {
 
   /// Urbi Lists.
+  ///
+  /// The elements are held by pointers in \c array.  Those created
+  /// by the list itself (push_back, append, copies, parsing) are
+  /// allocated in a few contiguous blocks it owns, rather than one by
+  /// one on the heap.  Elements added directly to \c array with new
+  /// are deleted by the list as before; the others must not be
+  /// deleted by the user.
   class URBI_SDK_API UList
   {
   public:
@@ -53,6 +60,12 @@ namespace urbi
     UList&
     push_back(const T& v);
 
+    /// Append a void element to the end, and return it.
+    UValue& append();
+
+    /// Prepare room for \a n elements.
+    void reserve(size_t n);
+
     void pop_back();
 
     UValue& front();
@@ -76,6 +89,19 @@ namespace urbi
     void clear();
     size_t offset;
     friend class UValue;
+
+    /// A block of elements.
+    struct Block;
+    /// The blocks, the most recent first.
+    Block* blocks_;
+    /// Room for one more element in the current block.
+    void* slot_();
+    /// Add a new block, with room for at least \a n elements.
+    void grow_(size_t n);
+    /// Record \a v, just built in slot_(), as the last element.
+    void adopt_(UValue* v);
+    /// Whether \a v is allocated in the blocks.
+    bool owns_(const UValue* v) const;
   };
 
   URBI_SDK_API
@@ -10,6 +10,8 @@
 
 /// \file urbi/ulist.hxx
 
+#include <new>
+
 #include <libport/preproc.hh>
 #include <boost/lexical_cast.hpp>
 #include <urbi/uvalue.hh>
@@ -86,10 +88,19 @@ namespace urbi
   UList&
   UList::push_back(const T& v)
   {
-    array.push_back(new UValue(v));
+    adopt_(new (slot_()) UValue(v));
     return *this;
   }
 
+  inline
+  UValue&
+  UList::append()
+  {
+    UValue* res = new (slot_()) UValue();
+    adopt_(res);
+    return *res;
+  }
+
   inline
   UValue&
   UList::front()
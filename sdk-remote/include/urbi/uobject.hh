@@ -133,7 +133,7 @@
  *         maximum queue size.
  */
 # define UBindThreadedFunctionRename(Obj, X, Uname, LockMode)           \
-  UBindFunctionRename(Obj, X, Uname)->setAsync(getTaskLock(LockMode, Uname))
+  setCallbackAsync(UBindFunctionRename(Obj, X, Uname), LockMode, Uname)
 
 # define UBindThreadedFunction(Obj, X, LockMode)        \
   UBindThreadedFunctionRename(Obj, X, #X, LockMode)
@@ -148,7 +148,7 @@
 
 /// Same as UAt() but executes the code in a separate thread.
 # define UThreadedAt(Obj, X, LockMode)                  \
-  UAt(Obj, X)->setAsync(getTaskLock(LockMode, #X))
+  setCallbackAsync(UAt(Obj, X), LockMode, #X)
 
 
 /** Registers a function \a X in current object that will be called each
@@ -161,7 +161,7 @@
   URBI_CREATE_CALLBACK(eventend, (&Obj::X), (&Obj::Fun), __name + "." #X)
 
 # define UThreadedAtEnd(Obj, X, Fun, LockMode)                  \
-  UAtEnd(Obj, X, Fun)->setAsync(getTaskLock(LockMode, #X))
+  setCallbackAsync(UAtEnd(Obj, X, Fun), LockMode, #X)
 
 /// Register current object to the UObjectHub named \a Hub.
 # define URegister(Hub)						\
@@ -250,17 +250,26 @@ namespace urbi
   };
 
   /** Extended locking model specifications.
-   * Permits to set the maximum queue size which is infinite by default.
+   * Permits to set the maximum queue size which is infinite by default,
+   * and what to do with the calls that do not fit in the queue.
+   *
+   * With OVERFLOW_DROP_NEWEST, the queue is the one of the lock, and it
+   * is bounded only for LOCK_FUNCTION; the running call counts in its
+   * size.  Otherwise, the queue is per callback, and holds only the
+   * waiting calls.
    */
   class URBI_SDK_API LockSpec
   {
   public:
-    LockSpec(LockMode l, unsigned int maxQueueSize = 0)
+    LockSpec(LockMode l, unsigned int maxQueueSize = 0,
+             OverflowPolicy overflow = OVERFLOW_DROP_NEWEST)
       : lockMode(l)
       , maxQueueSize(maxQueueSize)
+      , overflow(overflow)
     {}
     LockMode lockMode;
     unsigned int maxQueueSize;
+    OverflowPolicy overflow;
   };
 
   /** LockSpec that prevents parallel calls to the function, and drops all
@@ -274,6 +283,13 @@ namespace urbi
    */
   static const LockSpec LOCK_FUNCTION_KEEP_ONE = LockSpec(LOCK_FUNCTION, 2);
 
+  /** LockSpec that prevents parallel calls to the function, and keeps
+   * only the latest call while one is running.  Suited to sensors: the
+   * function is always called with the latest value.
+   */
+  static const LockSpec LOCK_FUNCTION_COALESCE =
+    LockSpec(LOCK_FUNCTION, 1, OVERFLOW_COALESCE);
+
   UObjectHub* getUObjectHub(const std::string& n);
   UObject* getUObject(const std::string& n);
   void uobject_unarmorAndSend(const char* str);
@@ -396,17 +412,19 @@ namespace urbi
     void UNotifyThreaded##Type(Notified, F fun,		\
                                LockMode lockMode)	\
     {							\
-	createUCallback(*this, StoreArg, TypeString,	\
-                        this, fun, Name)		\
-          ->setAsync(getTaskLock(lockMode, Name));	\
+	setCallbackAsync(createUCallback(*this, StoreArg,	\
+                                         TypeString,		\
+                                         this, fun, Name),	\
+                         lockMode, Name);			\
     }                                                   \
     template <typename F>				\
     void UNotifyThreaded##Type(Notified, F fun,		\
                                LockSpec lockMode)	\
     {							\
-	createUCallback(*this, StoreArg, TypeString,	\
-                        this, fun, Name)		\
-          ->setAsync(getTaskLock(lockMode, Name));	\
+	setCallbackAsync(createUCallback(*this, StoreArg,	\
+                                         TypeString,		\
+                                         this, fun, Name),	\
+                         lockMode, Name);			\
     }
 
 
@@ -511,6 +529,9 @@ namespace urbi
     /// Find the TaskLock associated with lock specs \b s.
     libport::ThreadPool::rTaskLock getTaskLock(LockSpec s,
                                                const std::string& what);
+    /// Make \b cb asynchronous, with the lock and queue of \b s.
+    void setCallbackAsync(UGenericCallback* cb, LockSpec s,
+                          const std::string& what);
     /// The load attribute is standard and can be used to control the
     /// activity of the object.
     UVar load;
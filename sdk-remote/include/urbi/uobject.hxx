@@ -103,7 +103,9 @@ namespace urbi
         rTaskLock& res = taskLocks_[what];
         if (!res)
         {
-          res = new TaskLock(m.maxQueueSize);
+          // The other policies are implemented by the callback.
+          res = new TaskLock(m.overflow == OVERFLOW_DROP_NEWEST
+                             ? m.maxQueueSize : 0);
           GD_FINFO_TRACE("Creating taskLock for %s with %s: %s", what,
                          m.maxQueueSize, res.get());
         }
@@ -124,6 +126,15 @@ namespace urbi
   }
 
 
+  inline
+  void
+  UObject::setCallbackAsync(UGenericCallback* cb, LockSpec s,
+                            const std::string& what)
+  {
+    cb->setAsync(getTaskLock(s, what), s.maxQueueSize, s.overflow);
+  }
+
+
 #ifndef NO_UOBJECT_CASTER
   inline UObject*
   uvalue_caster<UObject*>::operator()(UValue& v)
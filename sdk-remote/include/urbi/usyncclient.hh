@@ -15,6 +15,11 @@
 #ifndef URBI_USYNCCLIENT_HH
 # define URBI_USYNCCLIENT_HH
 
+# include <map>
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+
 # include <libport/finally.hh>
 # include <libport/fwd.hh>
 # include <libport/lockable.hh>
@@ -106,6 +111,43 @@ namespace urbi
       static const send_options default_options;
     };
 
+    /// The answer to a request sent by asyncGet.
+    ///
+    /// The answers are routed to their future by their tag, so that
+    /// any number of requests may be pending on a connection.
+    class URBI_SDK_API Future
+    {
+    public:
+      ~Future();
+
+      /// Wait for the answer for at most \a useconds, or forever if 0.
+      /// Can be called several times.
+      /// \return the answer, owned by the future, or 0 on time out or
+      ///   if the connection was closed.
+      const UMessage* get(libport::utime_t useconds = 0);
+
+      /// Whether the answer was received, or will never be.
+      bool ready() const;
+
+      /// The tag of the answer.
+      const std::string& tag() const;
+
+    private:
+      friend class USyncClient;
+      explicit Future(const std::string& tag);
+      /// Store \a msg, 0 if the connection is closed, and wake up get.
+      void complete(UMessage* msg);
+
+      std::string tag_;
+      UMessage* message_;
+      bool ready_;
+      /// Whether get is waiting from the socket polling thread.
+      bool waitingFromPollThread_;
+      libport::Semaphore sem_;
+      mutable libport::Lockable lock_;
+    };
+    typedef boost::shared_ptr<Future> future_type;
+
   protected:
     virtual error_type onClose ();
 
@@ -126,7 +168,22 @@ namespace urbi
     syncGet_(const char* expression, va_list& arg,
 	     const send_options& options = send_options::default_options);
 
+    /// Send the request for \a expression, return its future, or 0
+    /// in case of error.
+    future_type
+    asyncGet_(const char* expression, va_list& arg,
+              const send_options& options = send_options::default_options);
+
   public:
+    /// Asynchronously evaluate an Urbi expression. The expression must
+    /// not start with a tag or channel.  Do not wait for the answer:
+    /// several requests can be pending at the same time.
+    ATTRIBUTE_PRINTF(2, 3)
+    future_type asyncGet(const char* expression, ...);
+
+    /// Asynchronously evaluate an Urbi expression.
+    future_type asyncGet(const std::string& exp);
+
     /// Synchronously evaluate an Urbi expression. The expression must
     /// not start with a tag or channel.
     ATTRIBUTE_PRINTF(2, 3)
@@ -169,6 +226,17 @@ namespace urbi
     int syncGetValue(const char* tag, const char* valName, UValue& val,
 		     libport::utime_t useconds = 0);
 
+    /// Get the values of \a valNames in a synchronous way.  All the
+    /// requests are sent at once, and the answers are processed as
+    /// they arrive, so the whole costs a single round trip.
+    /// \param vals  resized to the number of names.
+    /// \param useconds  timeout for all the answers, 0 for none.
+    /// \return the number of values successfully received, 0 if the
+    ///   requests could not be sent.
+    size_t syncGetValues(const std::vector<std::string>& valNames,
+                         std::vector<UValue>& vals,
+                         libport::utime_t useconds = 0);
+
     /// Get the value of device.val in a synchronous way.
     /// \return 1 on success, 0 on failure.
     int syncGetDevice(const char* device, ufloat &val,
@@ -284,6 +352,11 @@ namespace urbi
     libport::Semaphore syncLock_;
     std::string syncTag;
 
+    /// The requests sent by asyncGet and not answered yet, indexed by
+    /// tag.  Protected by queueLock_.
+    typedef std::map<std::string, future_type> futures_type;
+    futures_type futures_;
+
     send_options default_options_;
 
     bool stopCallbackThread_;
@@ -136,18 +136,21 @@ namespace urbi
       std::string headers;
       ar >> headers;
       ar >> sz;
-      void* data = malloc(sz);
+      size_t capacity;
+      void* data = frame_pool::acquire(sz, capacity);
       is.read((char*)data, sz);
       binaries_type bins;
-      bins.push_back(BinaryData(data, sz));
+      // Let the binary adopt the buffer.
+      bins.push_back(BinaryData(data, sz, true, capacity));
       v.type = DATA_BINARY;
       v.binary = new UBinary;
       binaries_type::const_iterator i = bins.begin();
       headers = (string_cast(sz)
                  + (headers.empty() ? "" : " ")
                  + headers +";");
-      v.binary->parse(headers.c_str(), 0, bins, i, false);
-      v.binary->allocated_ = true;
+      v.binary->parse(headers.c_str(), 0, bins, i);
+      // Free the buffer if the binary did not take it.
+      bins.front().clear();
     }
     break;
 
@@ -174,12 +177,9 @@ namespace urbi
     case DATA_LIST:
       ar >> sz;
       v = UList();
+      v.list->reserve(sz);
       for (size_t i=0; i<sz; ++i)
-      {
-        UValue* val = new UValue;
-        ar >> *val;
-        v.list->array.push_back(val);
-      }
+        ar >> v.list->append();
       break;
 
     case DATA_STRING:
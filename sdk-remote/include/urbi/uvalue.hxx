@@ -66,11 +66,7 @@ namespace urbi
     for (typename Type<T>::const_iterator i = v.begin(),        \
            i_end = v.end();                                     \
          i != i_end; ++i)                                       \
-    {                                                           \
-      UValue r;                                                 \
-      r, *i;                                                    \
-      b.list->array.push_back(new UValue(r));                   \
-    }                                                           \
+      b.list->append(), *i;                                     \
     return b;                                                   \
   }
 
@@ -283,14 +279,10 @@ namespace urbi
   UList&
   UList::operator=(const T& container)
   {
-    array.clear();
+    clear();
     typedef const typename T::value_type constv;
     BOOST_FOREACH (constv& v, container)
-    {
-      UValue val;
-      val,v;
-      array.push_back(new UValue(val));
-    }
+      append(), v;
     return *this;
   }
 
@@ -10,6 +10,7 @@ bin_PROGRAMS +=					\
   examples/urbi-bandwidth			\
   examples/urbi-mirror				\
   examples/urbi-ping				\
+  examples/urbi-pipeline-bench			\
   examples/urbi-play				\
   examples/urbi-record				\
   examples/urbi-send				\
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2005-2011, Gostai S.A.S.
+ * Copyright (C) 2005-2012, Gostai S.A.S.
  *
  * This software is provided "as is" without warranty of any kind,
  * either expressed or implied, including but not limited to the
@@ -12,13 +12,17 @@
 #include <libport/sys/types.h>
 #include <libport/sys/stat.h>
 #include <libport/csignal>
+#include <libport/cstdlib>
+#include <libport/utime.hh>
 #include <libport/windows.hh>
 
 #include <urbi/uclient.hh>
 
 bool over = false;
-static int totalsize = 0;
-static int starttime = 0;
+static size_t count = 10;
+static size_t received = 0;
+static size_t totalsize = 0;
+static libport::utime_t starttime = 0;
 
 static urbi::UCallbackAction
 bw(const urbi::UMessage &msg)
@@ -30,14 +34,18 @@ bw(const urbi::UMessage &msg)
   totalsize += (msg.value->binary->image.size
 		+ msg.tag.size ()
 		+ 20);
+  ++received;
 
-  if (msg.tag != "be")
+  if (msg.tag == "be")
   {
-    msg.client.printf("received %d bytes in %d miliseconds: "
-                      "bandwidth is %d bytes per second.\n",
-                      totalsize,
-                      msg.client.getCurrentTime()-starttime,
-                      totalsize*1000/(msg.client.getCurrentTime()-starttime));
+    libport::utime_t d = std::max(libport::utime() - starttime,
+                                  libport::utime_t(1));
+    msg.client.printf("received %zu images, %zu bytes in %lld microseconds: "
+                      "bandwidth is %lld bytes per second, "
+                      "%lld images per second.\n",
+                      received, totalsize, (long long) d,
+                      (long long) (totalsize * 1000000LL / d),
+                      (long long) (received * 1000000LL / d));
 
     over = true;
   }
@@ -47,18 +55,21 @@ bw(const urbi::UMessage &msg)
 
 int main(int argc, char * argv[])
 {
-  if (argc != 2)
+  if (argc != 2 && argc != 3)
   {
-    printf("usage: %s robot\n", argv[0]);
+    printf("usage: %s robot [images]\n", argv[0]);
     urbi::exit(1);
   }
+  if (argc == 3)
+    count = std::max(atoi(argv[2]), 1);
 
   urbi::UClient c (argv[1]);
 
   if (c.error())
     urbi::exit(1);
 
-  c.printf("Requesting raw images from server to test bandwidth...\n");
+  c.printf("Requesting %zu raw images from server to test bandwidth...\n",
+           count);
 
   c.setCallback(bw,"bw");
   c.setCallback(bw,"be");
@@ -72,9 +83,9 @@ int main(int argc, char * argv[])
     "  be = Channel.new(\"be\")|;\n"
     "};\n";
 
-  starttime = c.getCurrentTime();
+  starttime = libport::utime();
   c <<
-    "for (var i = 0; i < 9 ; i++)\n"
+    "for (var i = 0; i < " << count - 1 << " ; i++)\n"
     "  bw << camera.val|\n"
     "be << camera.val;\n" << std::endl;
   urbi::execute();
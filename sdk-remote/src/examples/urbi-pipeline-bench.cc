@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <libport/cli.hh>
+#include <libport/foreach.hh>
+#include <libport/format.hh>
+#include <libport/option-parser.hh>
+#include <libport/package-info.hh>
+#include <libport/program-name.hh>
+#include <libport/sysexits.hh>
+#include <libport/utime.hh>
+
+#include <urbi/package-info.hh>
+#include <urbi/umessage.hh>
+#include <urbi/usyncclient.hh>
+
+using libport::program_name;
+
+namespace
+{
+  static
+  void
+  usage(libport::OptionParser& parser)
+  {
+    std::cout <<
+      "usage: " << program_name() << " [HOST] [COUNT] [ROUNDS]\n"
+      "Measure the latency and the throughput of the requests of\n"
+      "USyncClient, one at a time (syncGetValue), pipelined (asyncGet),\n"
+      "and batched (syncGetValues), over ROUNDS rounds of COUNT requests.\n"
+                << parser
+                << "\n"
+                << urbi::package_info().report_bugs()
+                << std::endl
+                << libport::exit(EX_OK);
+  }
+
+  static
+  void
+  version()
+  {
+    std::cout << "urbi-pipeline-bench" << std::endl
+              << urbi::package_info() << std::endl
+              << libport::exit(EX_OK);
+  }
+
+  static
+  void
+  failed(const char* what)
+  {
+    std::cerr << program_name() << ": " << what << " failed" << std::endl
+              << libport::exit(EX_FAIL);
+  }
+
+  /// Report the time elapsed since \a start for \a n requests.
+  static
+  void
+  report(const char* what, libport::utime_t start, size_t n)
+  {
+    libport::utime_t d = std::max(libport::utime() - start,
+                                  libport::utime_t(1));
+    std::cout << libport::format("%-14s %s requests in %sus, %sus/request,"
+                                 " %s requests/s",
+                                 what, n, d, d / n, n * 1000000 / d)
+              << std::endl;
+  }
+}
+
+
+int
+main(int argc, char* argv[])
+try
+{
+  libport::program_initialize(argc, argv);
+
+  libport::OptionValue
+    arg_count("number of requests per round (64)",
+              "count", 'c', "COUNT"),
+    arg_rounds("number of rounds (32)",
+               "rounds", 'r', "ROUNDS");
+
+  // Parse the command line.
+  libport::OptionParser opt_parser;
+  opt_parser << "Options:"
+             << arg_count
+             << libport::opts::help
+             << libport::opts::host
+             << libport::opts::port
+             << libport::opts::port_file
+             << arg_rounds
+             << libport::opts::version;
+
+  libport::cli_args_type args = opt_parser(libport::program_arguments());
+
+  foreach (const std::string& arg, args)
+    if (arg[0] == '-')
+      libport::invalid_option(arg);
+  if (libport::opts::help.get())
+    usage(opt_parser);
+  if (libport::opts::version.get())
+    version();
+
+  /// Server host name.
+  std::string host = libport::opts::host.value(urbi::UClient::default_host());
+  /// Server port.
+  int port = libport::opts::port.get<int>(urbi::UClient::URBI_PORT);
+  if (libport::opts::port_file.filled())
+    port = libport::file_contents_get<int>(libport::opts::port_file.value());
+
+  unsigned count = arg_count.get<unsigned>(64u);
+  unsigned rounds = arg_rounds.get<unsigned>(32u);
+  switch (args.size())
+  {
+  case 3: rounds = libport::convert_argument<unsigned>("rounds", args[2]);
+  case 2: count = libport::convert_argument<unsigned>("count", args[1]);
+  case 1: host = args[0];
+  case 0: break;
+  default:
+    libport::usage_error("invalid number of arguments");
+  }
+  if (!count)
+    libport::usage_error("invalid count: 0");
+
+  // Client initialization.
+  urbi::USyncClient client(host, port);
+  if (client.error())
+    std::cerr << program_name() << ": client failed to set up"
+              << std::endl
+              << libport::exit(1);
+  client.waitForKernelVersion();
+
+  client.send("var pipelineBench = []|;\n"
+              "for (var i: %u) pipelineBench << i|;\n", count);
+  std::vector<std::string> names;
+  for (unsigned i = 0; i < count; ++i)
+    names.push_back(libport::format("pipelineBench[%s]", i));
+  urbi::UValue v;
+  if (!client.syncGetValue("pipelineBench.size", v))
+    failed("setup");
+
+  // One request at a time: one round trip each.
+  libport::utime_t start = libport::utime();
+  for (unsigned r = 0; r < rounds; ++r)
+    for (unsigned i = 0; i < count; ++i)
+      if (!client.syncGetValue(names[i].c_str(), v))
+        failed("syncGetValue");
+  report("syncGetValue", start, rounds * count);
+
+  // All the requests of a round pending at once.
+  start = libport::utime();
+  for (unsigned r = 0; r < rounds; ++r)
+  {
+    std::vector<urbi::USyncClient::future_type> fs;
+    for (unsigned i = 0; i < count; ++i)
+      fs.push_back(client.asyncGet("%s;", names[i].c_str()));
+    foreach (const urbi::USyncClient::future_type& f, fs)
+      if (!f || !f->get())
+        failed("asyncGet");
+  }
+  report("asyncGet", start, rounds * count);
+
+  // A round in a single call.
+  start = libport::utime();
+  std::vector<urbi::UValue> vals;
+  for (unsigned r = 0; r < rounds; ++r)
+    if (client.syncGetValues(names, vals) != count)
+      failed("syncGetValues");
+  report("syncGetValues", start, rounds * count);
+}
+catch (const std::exception& e)
+{
+  std::cerr << program_name() << ": " << e.what() << std::endl
+            << libport::exit(EX_FAIL);
+}
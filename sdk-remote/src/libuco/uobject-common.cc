@@ -8,6 +8,7 @@
  * See the LICENSE file for more information.
  */
 
+#include <algorithm>
 #include <cstdarg>
 #include <typeinfo>
 
@@ -79,6 +80,8 @@ namespace urbi
     , target(target)
     , owner(owner)
     , synchronous_(true)
+    , maxQueueSize_(0)
+    , overflow_(OVERFLOW_DROP_NEWEST)
   {
     if (target)
       target->check();
@@ -98,6 +101,8 @@ namespace urbi
     , target(target)
     , owner(owner)
     , synchronous_(true)
+    , maxQueueSize_(0)
+    , overflow_(OVERFLOW_DROP_NEWEST)
   {
     if (target)
       target->check();
@@ -154,21 +159,120 @@ namespace urbi
     {
       syncEval(params, onDone);
     }
+    else if (overflow_ != OVERFLOW_DROP_NEWEST)
+      queueEval(params, onDone);
     else
     {
+      {
+        libport::BlockLock bl(queueLock_);
+        queueStats_.maxSize = std::max(queueStats_.maxSize,
+                                       ++queueStats_.size);
+      }
       libport::ThreadPool::rTaskHandle h
        = threadPool().queueTask(
                              boost::function0<void>(
-        boost::bind(&UGenericCallback::syncEval, this, params, onDone)),
+        boost::bind(&UGenericCallback::runTask, this, params, onDone,
+                    libport::utime())),
         taskLock);
        GD_FINFO_TRACE("Queued async op: with lock %s: %s", taskLock.get(),
                       h->getState());
-      if (h->getState() == libport::ThreadPool::TaskHandle::DROPPED && onDone)
+      if (h->getState() == libport::ThreadPool::TaskHandle::DROPPED)
+      {
+        {
+          libport::BlockLock bl(queueLock_);
+          --queueStats_.size;
+          ++queueStats_.dropped;
+        }
+        if (onDone)
+        {
+          UValue res;
+          onDone(res, 0);
+        }
+      }
+    }
+  }
+
+  void
+  UGenericCallback::queueEval(UList& params, OnDone onDone)
+  {
+    Pending p;
+    p.params.reset(new UList(params));
+    p.onDone = onDone;
+    p.date = libport::utime();
+    Pending dropped;
+    {
+      libport::BlockLock bl(queueLock_);
+      size_t max = overflow_ == OVERFLOW_COALESCE ? 1 : maxQueueSize_;
+      if (max && max <= pending_.size())
+      {
+        dropped = pending_.front();
+        pending_.pop_front();
+        ++queueStats_.dropped;
+      }
+      pending_.push_back(p);
+      queueStats_.size = pending_.size();
+      queueStats_.maxSize = std::max(queueStats_.maxSize, queueStats_.size);
+    }
+    GD_FINFO_TRACE("Queued async op: with lock %s, %s dropped",
+                   taskLock.get(), dropped.params ? 1 : 0);
+    // There is one task per pending call: the task of the dropped call
+    // runs the new one.
+    if (dropped.params)
+    {
+      if (dropped.onDone)
       {
         UValue res;
-        onDone(res, 0);
+        dropped.onDone(res, 0);
       }
     }
+    else
+      threadPool().queueTask(
+        boost::function0<void>(
+          boost::bind(&UGenericCallback::runPending, this)),
+        taskLock);
+  }
+
+  void
+  UGenericCallback::callStarted(libport::utime_t date)
+  {
+    libport::utime_t latency = libport::utime() - date;
+    ++queueStats_.started;
+    queueStats_.latency += latency;
+    queueStats_.maxLatency = std::max(queueStats_.maxLatency, latency);
+  }
+
+  void
+  UGenericCallback::runPending()
+  {
+    Pending p;
+    {
+      libport::BlockLock bl(queueLock_);
+      aver(!pending_.empty());
+      p = pending_.front();
+      pending_.pop_front();
+      queueStats_.size = pending_.size();
+      callStarted(p.date);
+    }
+    syncEval(*p.params, p.onDone);
+  }
+
+  void
+  UGenericCallback::runTask(UList& params, OnDone onDone,
+                            libport::utime_t date)
+  {
+    {
+      libport::BlockLock bl(queueLock_);
+      --queueStats_.size;
+      callStarted(date);
+    }
+    syncEval(params, onDone);
+  }
+
+  UGenericCallback::QueueStats
+  UGenericCallback::queueStats() const
+  {
+    libport::BlockLock bl(queueLock_);
+    return queueStats_;
   }
 
   /* Note: to implement the LOCK_MODULE mode, we must delegate search of the
@@ -176,10 +280,14 @@ namespace urbi
    * That is why we take the TaskLock here and we do not find it ourselve.
    */
   void
-  UGenericCallback::setAsync(libport::ThreadPool::rTaskLock l)
+  UGenericCallback::setAsync(libport::ThreadPool::rTaskLock l,
+                             unsigned int maxQueueSize,
+                             OverflowPolicy overflow)
   {
     synchronous_ = false;
     taskLock = l;
+    maxQueueSize_ = maxQueueSize;
+    overflow_ = overflow;
   }
 
   libport::ThreadPool&
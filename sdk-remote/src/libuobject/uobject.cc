@@ -91,6 +91,28 @@ namespace urbi
           args.setOffset(0);
         }
       }
+
+      /// An input stream buffer on memory, without copying it.
+      class MemoryStreamBuffer: public std::streambuf
+      {
+      public:
+        MemoryStreamBuffer(void* data, size_t size)
+        {
+          char* p = static_cast<char*>(data);
+          setg(p, p, p + size);
+        }
+      };
+
+      /// Whether \a v is a message serialized by the kernel (see
+      /// uobjects.serializeMessage in uobject.u).
+      static
+      bool
+      is_serialized_message(const UValue& v)
+      {
+        return (v.type == DATA_BINARY
+                && v.binary->type == BINARY_UNKNOWN
+                && v.binary->message == "uem");
+      }
     }
 
     typedef boost::unordered_map<std::string, impl::UContextImpl*>
@@ -546,11 +568,31 @@ namespace urbi
       REQUIRE(msg.type == MESSAGE_DATA,
               "Component Error: unknown message content, type %d\n",
               msg.type);
-      REQUIRE(msg.value->type == DATA_LIST,
+      // Messages in binary mode are serialized, not printed.
+      UValue serialized;
+      UValue* value = msg.value;
+      if (is_serialized_message(*value))
+      {
+        MemoryStreamBuffer buf(value->binary->common.data,
+                               value->binary->common.size);
+        std::istream is(&buf);
+        libport::serialize::BinaryISerializer ia(is);
+        try
+        {
+          ia >> serialized;
+        }
+        catch (const std::exception& e)
+        {
+          GD_FERROR("invalid serialized message: %s", e.what());
+          return URBI_CONTINUE;
+        }
+        value = &serialized;
+      }
+      REQUIRE(value->type == DATA_LIST,
               "Component Error: unknown message content, value type %d\n",
-              msg.value->type);
+              value->type);
 
-      UList& array = *msg.value->list;
+      UList& array = *value->list;
       GD_FINFO_DUMP("Dispatching %s, first %s", array, array[0]);
       REQUIRE(array[0].type == DATA_DOUBLE,
               "Component Error: invalid server message type %d\n",
@@ -729,7 +771,7 @@ namespace urbi
         {
           // test of return value here
           UList u;
-          u.array.push_back(new UValue());
+          u.append();
           u[0].storage = c->target;
           c->eval(u);
         }
@@ -1036,7 +1078,10 @@ namespace urbi
       // Do not send any other message until we get a reply.
       backend_->lockQueue();
       const char* tag = "remotecontext_setmode";
-      send(libport::format("binaryMode(%s, \"%s\");\n", mode, tag));
+      // Also ask for serialized messages, if the kernel can send them.
+      send(libport::format("if (uobjects.hasSlot(\"serializeMessage\"))\n"
+                           "  var lobby.binaryMessages = true;\n"
+                           "binaryMode(%s, \"%s\");\n", mode, tag));
       delete backend_->waitForTag(tag, 0);
       // Change the urbiscript outputstream to one that encapsulates
       // in UValue and serializes.
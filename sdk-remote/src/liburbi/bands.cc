@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/bands.cc
+/// \brief Implementation of urbi::bands.
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <liburbi/bands.hh>
+
+namespace urbi
+{
+  namespace bands
+  {
+    namespace
+    {
+      /// The worker threads, and the job they share.
+      class Pool
+      {
+      public:
+        Pool()
+          : workers_(0)
+          , job_(0)
+          , rows_(0)
+          , band_rows_(0)
+          , bands_(0)
+          , next_(0)
+          , pending_(0)
+          , helpers_(0)
+          , joined_(0)
+        {}
+
+        /// Run \a job on \a rows rows in bands of \a band_rows, with
+        /// the help of \a helpers workers.
+        /// \return false if the pool is already busy.
+        bool
+        run(size_t rows, size_t band_rows, size_t helpers,
+            const job_type& job)
+        {
+          boost::mutex::scoped_try_lock busy(busy_);
+          if (!busy)
+            return false;
+
+          boost::mutex::scoped_lock lock(mutex_);
+          for (; workers_ < helpers; ++workers_)
+            boost::thread(boost::bind(&Pool::work, this)).detach();
+          job_ = &job;
+          rows_ = rows;
+          band_rows_ = band_rows;
+          bands_ = (rows + band_rows - 1) / band_rows;
+          next_ = 0;
+          pending_ = bands_;
+          helpers_ = helpers;
+          work_.notify_all();
+
+          // Take our share.
+          run_bands_(lock);
+          while (pending_)
+            done_.wait(lock);
+          job_ = 0;
+          return true;
+        }
+
+      private:
+        /// Run the bands left, \a lock is held in between.
+        void
+        run_bands_(boost::mutex::scoped_lock& lock)
+        {
+          while (job_ && next_ < bands_)
+          {
+            const job_type& job = *job_;
+            size_t begin = next_++ * band_rows_;
+            size_t end = std::min(rows_, begin + band_rows_);
+            lock.unlock();
+            job(begin, end);
+            lock.lock();
+            if (!--pending_)
+              done_.notify_all();
+          }
+        }
+
+        /// The body of the workers.
+        void
+        work()
+        {
+          boost::mutex::scoped_lock lock(mutex_);
+          while (true)
+          {
+            while (!job_ || next_ == bands_ || joined_ == helpers_)
+              work_.wait(lock);
+            ++joined_;
+            run_bands_(lock);
+            --joined_;
+          }
+        }
+
+        /// Held during a run.
+        boost::mutex busy_;
+        /// Protects the members below.
+        boost::mutex mutex_;
+        /// Signaled when there is a new job.
+        boost::condition_variable work_;
+        /// Signaled when all the bands are done.
+        boost::condition_variable done_;
+        /// The number of worker threads.
+        size_t workers_;
+
+        /// The current job, if any.
+        const job_type* job_;
+        size_t rows_;
+        size_t band_rows_;
+        size_t bands_;
+        /// The next band to process.
+        size_t next_;
+        /// The number of bands not finished.
+        size_t pending_;
+        /// The number of workers allowed to work on the job, and
+        /// working on it.
+        size_t helpers_;
+        size_t joined_;
+      };
+
+      static Pool&
+      pool()
+      {
+        // Never destroyed: the workers wait on it until the end.
+        static Pool* res = new Pool;
+        return *res;
+      }
+    }
+
+    void
+    run(size_t rows, const job_type& job,
+        size_t threads, size_t band_rows, size_t align)
+    {
+      if (!rows)
+        return;
+      // A few bands per thread, to balance the load.
+      size_t band = std::max(std::max(band_rows, size_t(1)),
+                             rows / (4 * std::max(threads, size_t(1))));
+      band = (band + align - 1) / align * align;
+      if (threads <= 1 || rows <= band
+          || !pool().run(rows, band,
+                         std::min(threads, (rows + band - 1) / band) - 1,
+                         job))
+        job(0, rows);
+    }
+  }
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/bands.hh
+/// \brief Processing of the rows of an image on several threads.
+
+#ifndef LIBURBI_BANDS_HH
+# define LIBURBI_BANDS_HH
+
+# include <cstddef>
+
+# include <boost/function.hpp>
+
+# include <urbi/export.hh>
+
+namespace urbi
+{
+  namespace bands
+  {
+    /// A job on the rows [begin, end) of an image.
+    typedef boost::function2<void, size_t, size_t> job_type;
+
+    /// Run \a job on the rows [0, \a rows), split in bands of at least
+    /// \a band_rows rows, which start on a multiple of \a align.  The
+    /// bands are processed by \a threads threads, the calling one
+    /// included, and this returns once they are all done.
+    ///
+    /// The worker threads are created on demand, and shared by all the
+    /// calls.  If they are busy with another call, or if \a threads is
+    /// 1, \a job is run on all the rows in the calling thread.
+    ///
+    /// Large function objects are best given with boost::ref, which
+    /// job_type stores without allocating.
+    URBI_SDK_API void
+    run(size_t rows, const job_type& job,
+        size_t threads, size_t band_rows = 16, size_t align = 2);
+  }
+}
+
+#endif // ! LIBURBI_BANDS_HH
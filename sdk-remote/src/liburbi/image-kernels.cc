@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/image-kernels.cc
+/// \brief Implementation of urbi::image_kernels.
+
+#if defined __AVX2__
+# define URBI_IMAGE_KERNELS_AVX2
+# include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && 2 <= _M_IX86_FP)
+# define URBI_IMAGE_KERNELS_SSE2
+# include <emmintrin.h>
+#endif
+
+#include <liburbi/image-kernels.hh>
+
+namespace urbi
+{
+  namespace image_kernels
+  {
+    namespace
+    {
+      inline byte
+      clamp(int v)
+      {
+        return (v < 0     ? 0
+                : 255 < v ? 255
+                :           v);
+      }
+
+      /// Same as convertYCbCrtoRGB on one pixel.
+      inline void
+      ycbcr_to_rgb(int y, int cb, int cr, byte* out)
+      {
+        int c298 = (y - 16) * 298;
+        int d = cb - 128;
+        int e = cr - 128;
+        out[0] = clamp((c298 + 409 * e + 128) >> 8);
+        out[1] = clamp((c298 + 100 * d - 20 * e + 128) >> 8);
+        out[2] = clamp((c298 + 516 * d + 128) >> 8);
+      }
+
+      /// The coefficients of convertRGBtoGrey8_601, 0.299f, 0.587f
+      /// and 0.114f, are exactly these integers divided by 2^27.  They
+      /// are split in their 15 high and 12 low bits, so that the sums
+      /// fit in 32 bits.
+      enum
+      {
+        grey_r_hi = 9797,
+        grey_r_lo = 2588,
+        grey_g_hi = 19234,
+        grey_g_lo = 3344,
+        grey_b_hi = 3735,
+        grey_b_lo = 2261,
+      };
+
+      /// Same as convertRGBtoGrey8_601 on one pixel: the products of
+      /// the byte values by the float coefficients, and their sum, are
+      /// exact in double precision, so is the rounding here.
+      inline byte
+      grey(int r, int g, int b)
+      {
+        int hi = r * grey_r_hi + g * grey_g_hi + b * grey_b_hi;
+        int lo = r * grey_r_lo + g * grey_g_lo + b * grey_b_lo;
+        return clamp((hi + ((lo + (1 << 26)) >> 12)) >> 15);
+      }
+    }
+
+    const char*
+    flavor()
+    {
+#if defined URBI_IMAGE_KERNELS_AVX2
+      return "avx2";
+#elif defined URBI_IMAGE_KERNELS_SSE2
+      return "sse2";
+#else
+      return "scalar";
+#endif
+    }
+
+    void
+    nv12_to_grey8_scalar(const byte* src, size_t w, size_t h,
+                         size_t begin, size_t end, byte* dst)
+    {
+      const byte* uv = src + w * h;
+      dst += begin * w;
+      for (size_t y = begin; y < end; ++y)
+      {
+        const byte* py = src + y * w;
+        const byte* puv = uv + y / 2 * w;
+        for (size_t x = 0; x < w; ++x)
+        {
+          byte rgb[3];
+          ycbcr_to_rgb(py[x], puv[x & ~1], puv[x | 1], rgb);
+          *dst++ = grey(rgb[0], rgb[1], rgb[2]);
+        }
+      }
+    }
+
+    void
+    nv12_to_rgb_scalar(const byte* src, size_t w, size_t h,
+                       size_t begin, size_t end, byte* dst)
+    {
+      const byte* uv = src + w * h;
+      dst += begin * w * 3;
+      for (size_t y = begin; y < end; ++y)
+      {
+        const byte* py = src + y * w;
+        const byte* puv = uv + y / 2 * w;
+        for (size_t x = 0; x < w; ++x, dst += 3)
+          ycbcr_to_rgb(py[x], puv[x & ~1], puv[x | 1], dst);
+      }
+    }
+
+    void
+    rgb_to_grey8_scalar(const byte* src, size_t w, size_t,
+                        size_t begin, size_t end, byte* dst)
+    {
+      src += begin * w * 3;
+      dst += begin * w;
+      for (size_t i = 0, n = (end - begin) * w; i < n; ++i, src += 3)
+        dst[i] = grey(src[0], src[1], src[2]);
+    }
+
+    void
+    yuv422_to_rgb_scalar(const byte* src, size_t w, size_t,
+                         size_t begin, size_t end, byte* dst)
+    {
+      // Y0 U Y1 V for each pair of pixels.
+      src += begin * w * 2;
+      dst += begin * w * 3;
+      for (size_t i = 0, n = (end - begin) * w / 2; i < n;
+           ++i, src += 4, dst += 6)
+      {
+        ycbcr_to_rgb(src[0], src[1], src[3], dst);
+        ycbcr_to_rgb(src[2], src[1], src[3], dst + 3);
+      }
+    }
+
+    void
+    yuv420_to_ycbcr(const byte* src, size_t w, size_t h,
+                    size_t begin, size_t end, byte* dst)
+    {
+      // Only moves bytes: row by row, which is all that matters.
+      const byte* u = src + w * h;
+      const byte* v = u + w * h / 4;
+      dst += begin * w * 3;
+      for (size_t y = begin; y < end; ++y)
+      {
+        const byte* py = src + y * w;
+        const byte* pu = u + y / 2 * (w / 2);
+        const byte* pv = v + y / 2 * (w / 2);
+        for (size_t x = 0; x < w; ++x, dst += 3)
+        {
+          dst[0] = py[x];
+          dst[1] = pu[x / 2];
+          dst[2] = pv[x / 2];
+        }
+      }
+    }
+
+#if defined URBI_IMAGE_KERNELS_AVX2 || defined URBI_IMAGE_KERNELS_SSE2
+
+    /*-------------------------------------------------------------.
+    | The vector kernels, written once for 128 and 256 bit vectors. |
+    | The unpack and pack instructions of AVX2 work on each 128-bit  |
+    | lane separately: every unpack lo/hi is undone by a pack, which |
+    | keeps the pixels in order.                                     |
+    `-------------------------------------------------------------*/
+
+    namespace
+    {
+# if defined URBI_IMAGE_KERNELS_AVX2
+      typedef __m256i vec;
+#  define V(Op) _mm256_ ## Op
+
+      inline vec
+      load(const byte* p)
+      {
+        return _mm256_loadu_si256(reinterpret_cast<const vec*>(p));
+      }
+
+      inline void
+      store(byte* p, vec v)
+      {
+        _mm256_storeu_si256(reinterpret_cast<vec*>(p), v);
+      }
+
+      inline vec
+      zero()
+      {
+        return _mm256_setzero_si256();
+      }
+
+      /// Pack the 16-bit elements of \a a then \a b into bytes.
+      inline vec
+      pack_ordered(vec a, vec b)
+      {
+        return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+      }
+# else
+      typedef __m128i vec;
+#  define V(Op) _mm_ ## Op
+
+      inline vec
+      load(const byte* p)
+      {
+        return _mm_loadu_si128(reinterpret_cast<const vec*>(p));
+      }
+
+      inline void
+      store(byte* p, vec v)
+      {
+        _mm_storeu_si128(reinterpret_cast<vec*>(p), v);
+      }
+
+      inline vec
+      zero()
+      {
+        return _mm_setzero_si128();
+      }
+
+      /// Pack the 16-bit elements of \a a then \a b into bytes.
+      inline vec
+      pack_ordered(vec a, vec b)
+      {
+        return _mm_packus_epi16(a, b);
+      }
+# endif
+
+      /// The number of pixels converted at once.
+      enum { block = sizeof(vec) };
+
+      /// The 32-bit elements made of \a lo and \a hi, for madd.
+      inline vec
+      pair(short lo, short hi)
+      {
+        return V(set1_epi32)(int(static_cast<unsigned short>(lo)
+                                 | static_cast<unsigned>(hi) << 16));
+      }
+
+      /// The low bytes of the 16-bit elements of \a v.
+      inline vec
+      low_bytes(vec v)
+      {
+        return V(srli_epi16)(V(slli_epi16)(v, 8), 8);
+      }
+
+      /// ycbcr_to_rgb on 16-bit elements: \a c = Y - 16, \a d = Cb -
+      /// 128, \a e = Cr - 128.
+      inline void
+      ycbcr_to_rgb16(vec c, vec d, vec e, vec& r, vec& g, vec& b)
+      {
+        const vec k128 = V(set1_epi32)(128);
+        vec ce_lo = V(unpacklo_epi16)(c, e);
+        vec ce_hi = V(unpackhi_epi16)(c, e);
+        vec cd_lo = V(unpacklo_epi16)(c, d);
+        vec cd_hi = V(unpackhi_epi16)(c, d);
+        // Cr and 128, to add the rounding in the same madd.
+        vec ek_lo = V(unpacklo_epi16)(e, V(set1_epi16)(128));
+        vec ek_hi = V(unpackhi_epi16)(e, V(set1_epi16)(128));
+# define CHANNEL(Lo, Hi)                                        \
+        V(packs_epi32)(V(srai_epi32)(Lo, 8), V(srai_epi32)(Hi, 8))
+        r = CHANNEL(V(add_epi32)(V(madd_epi16)(ce_lo, pair(298, 409)), k128),
+                    V(add_epi32)(V(madd_epi16)(ce_hi, pair(298, 409)), k128));
+        g = CHANNEL(V(add_epi32)(V(madd_epi16)(cd_lo, pair(298, 100)),
+                                 V(madd_epi16)(ek_lo, pair(-20, 1))),
+                    V(add_epi32)(V(madd_epi16)(cd_hi, pair(298, 100)),
+                                 V(madd_epi16)(ek_hi, pair(-20, 1))));
+        b = CHANNEL(V(add_epi32)(V(madd_epi16)(cd_lo, pair(298, 516)), k128),
+                    V(add_epi32)(V(madd_epi16)(cd_hi, pair(298, 516)), k128));
+# undef CHANNEL
+      }
+
+      /// ycbcr_to_rgb on a block of pixels: \a y holds their luma, \a
+      /// uv their chroma, Cb then Cr for each pair of pixels.
+      inline void
+      ycbcr_to_rgb(vec y, vec uv, vec& r, vec& g, vec& b)
+      {
+        const vec k16 = V(set1_epi16)(16);
+        const vec k128 = V(set1_epi16)(128);
+        vec u = V(sub_epi16)(low_bytes(uv), k128);
+        vec v = V(sub_epi16)(V(srli_epi16)(uv, 8), k128);
+        vec r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+        ycbcr_to_rgb16(V(sub_epi16)(V(unpacklo_epi8)(y, zero()), k16),
+                       V(unpacklo_epi16)(u, u), V(unpacklo_epi16)(v, v),
+                       r_lo, g_lo, b_lo);
+        ycbcr_to_rgb16(V(sub_epi16)(V(unpackhi_epi8)(y, zero()), k16),
+                       V(unpackhi_epi16)(u, u), V(unpackhi_epi16)(v, v),
+                       r_hi, g_hi, b_hi);
+        r = V(packus_epi16)(r_lo, r_hi);
+        g = V(packus_epi16)(g_lo, g_hi);
+        b = V(packus_epi16)(b_lo, b_hi);
+      }
+
+      /// grey on 16-bit elements.
+      inline vec
+      grey16(vec r, vec g, vec b)
+      {
+        const vec round = V(set1_epi32)(1 << 26);
+        vec rg_lo = V(unpacklo_epi16)(r, g);
+        vec rg_hi = V(unpackhi_epi16)(r, g);
+        vec b_lo = V(unpacklo_epi16)(b, zero());
+        vec b_hi = V(unpackhi_epi16)(b, zero());
+# define GREY(RG, B)                                                    \
+        V(srai_epi32)                                                   \
+          (V(add_epi32)                                                 \
+           (V(add_epi32)(V(madd_epi16)(RG, pair(grey_r_hi, grey_g_hi)), \
+                         V(madd_epi16)(B, pair(grey_b_hi, 0))),         \
+            V(srai_epi32)                                               \
+            (V(add_epi32)                                               \
+             (V(add_epi32)(V(madd_epi16)(RG, pair(grey_r_lo, grey_g_lo)), \
+                           V(madd_epi16)(B, pair(grey_b_lo, 0))),       \
+              round), 12)), 15)
+        return V(packs_epi32)(GREY(rg_lo, b_lo), GREY(rg_hi, b_hi));
+# undef GREY
+      }
+
+      /// grey on a block of pixels.
+      inline vec
+      grey(vec r, vec g, vec b)
+      {
+        return V(packus_epi16)(grey16(V(unpacklo_epi8)(r, zero()),
+                                      V(unpacklo_epi8)(g, zero()),
+                                      V(unpacklo_epi8)(b, zero())),
+                               grey16(V(unpackhi_epi8)(r, zero()),
+                                      V(unpackhi_epi8)(g, zero()),
+                                      V(unpackhi_epi8)(b, zero())));
+      }
+
+      /// Store a block of pixels as RGB.
+      inline void
+      store_rgb(byte* dst, vec r, vec g, vec b)
+      {
+        byte pr[block], pg[block], pb[block];
+        store(pr, r);
+        store(pg, g);
+        store(pb, b);
+        for (size_t i = 0; i < block; ++i, dst += 3)
+        {
+          dst[0] = pr[i];
+          dst[1] = pg[i];
+          dst[2] = pb[i];
+        }
+      }
+    }
+
+    void
+    nv12_to_grey8(const byte* src, size_t w, size_t h,
+                  size_t begin, size_t end, byte* dst)
+    {
+      const byte* uv = src + w * h;
+      dst += begin * w;
+      for (size_t y = begin; y < end; ++y)
+      {
+        const byte* py = src + y * w;
+        const byte* puv = uv + y / 2 * w;
+        size_t x = 0;
+        for (; x + block <= w; x += block, dst += block)
+        {
+          vec r, g, b;
+          ycbcr_to_rgb(load(py + x), load(puv + x), r, g, b);
+          store(dst, grey(r, g, b));
+        }
+        for (; x < w; ++x)
+        {
+          byte rgb[3];
+          ycbcr_to_rgb(py[x], puv[x & ~1], puv[x | 1], rgb);
+          *dst++ = grey(rgb[0], rgb[1], rgb[2]);
+        }
+      }
+    }
+
+    void
+    nv12_to_rgb(const byte* src, size_t w, size_t h,
+                size_t begin, size_t end, byte* dst)
+    {
+      const byte* uv = src + w * h;
+      dst += begin * w * 3;
+      for (size_t y = begin; y < end; ++y)
+      {
+        const byte* py = src + y * w;
+        const byte* puv = uv + y / 2 * w;
+        size_t x = 0;
+        for (; x + block <= w; x += block, dst += 3 * block)
+        {
+          vec r, g, b;
+          ycbcr_to_rgb(load(py + x), load(puv + x), r, g, b);
+          store_rgb(dst, r, g, b);
+        }
+        for (; x < w; ++x, dst += 3)
+          ycbcr_to_rgb(py[x], puv[x & ~1], puv[x | 1], dst);
+      }
+    }
+
+    void
+    rgb_to_grey8(const byte* src, size_t w, size_t,
+                 size_t begin, size_t end, byte* dst)
+    {
+      src += begin * w * 3;
+      dst += begin * w;
+      size_t n = (end - begin) * w;
+      size_t i = 0;
+      for (; i + block <= n; i += block, src += 3 * block)
+      {
+        byte pr[block], pg[block], pb[block];
+        for (size_t j = 0; j < block; ++j)
+        {
+          pr[j] = src[3 * j];
+          pg[j] = src[3 * j + 1];
+          pb[j] = src[3 * j + 2];
+        }
+        store(dst + i, grey(load(pr), load(pg), load(pb)));
+      }
+      for (; i < n; ++i, src += 3)
+        dst[i] = grey(src[0], src[1], src[2]);
+    }
+
+    void
+    yuv422_to_rgb(const byte* src, size_t w, size_t,
+                  size_t begin, size_t end, byte* dst)
+    {
+      src += begin * w * 2;
+      dst += begin * w * 3;
+      size_t n = (end - begin) * w;
+      size_t i = 0;
+      for (; i + block <= n; i += block, src += 2 * block, dst += 3 * block)
+      {
+        // Y0 U Y1 V for each pair of pixels: the Ys in the low bytes,
+        // the chroma in the high ones.
+        vec a = load(src);
+        vec b = load(src + block);
+        vec r, g, bl;
+        ycbcr_to_rgb(pack_ordered(low_bytes(a), low_bytes(b)),
+                     pack_ordered(V(srli_epi16)(a, 8), V(srli_epi16)(b, 8)),
+                     r, g, bl);
+        store_rgb(dst, r, g, bl);
+      }
+      // The remaining pixels, as a single row.
+      yuv422_to_rgb_scalar(src, n - i, 1, 0, 1, dst);
+    }
+
+# undef V
+
+#else // ! (URBI_IMAGE_KERNELS_AVX2 || URBI_IMAGE_KERNELS_SSE2)
+
+    void
+    nv12_to_grey8(const byte* src, size_t w, size_t h,
+                  size_t begin, size_t end, byte* dst)
+    {
+      nv12_to_grey8_scalar(src, w, h, begin, end, dst);
+    }
+
+    void
+    nv12_to_rgb(const byte* src, size_t w, size_t h,
+                size_t begin, size_t end, byte* dst)
+    {
+      nv12_to_rgb_scalar(src, w, h, begin, end, dst);
+    }
+
+    void
+    rgb_to_grey8(const byte* src, size_t w, size_t h,
+                 size_t begin, size_t end, byte* dst)
+    {
+      rgb_to_grey8_scalar(src, w, h, begin, end, dst);
+    }
+
+    void
+    yuv422_to_rgb(const byte* src, size_t w, size_t h,
+                  size_t begin, size_t end, byte* dst)
+    {
+      yuv422_to_rgb_scalar(src, w, h, begin, end, dst);
+    }
+
+#endif
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/image-kernels.hh
+/// \brief Direct conversions between the common image formats.
+
+#ifndef LIBURBI_IMAGE_KERNELS_HH
+# define LIBURBI_IMAGE_KERNELS_HH
+
+# include <cstddef>
+
+# include <urbi/export.hh>
+# include <urbi/uconversion.hh>
+
+namespace urbi
+{
+  namespace image_kernels
+  {
+    /// The instruction set used by the kernels: "avx2", "sse2" or
+    /// "scalar", chosen at compile time.
+    URBI_SDK_API const char* flavor();
+
+    /// The conversion of the rows [\a begin, \a end) of a \a w x \a
+    /// h image from \a src to \a dst, the whole images, which are
+    /// large enough for the formats.  \a w, \a h and \a begin are
+    /// even.  Different rows can be converted concurrently.
+    ///
+    /// The results are exactly those of the conversion through the
+    /// pivot image of urbi::convert.
+    typedef void (*kernel_type)(const byte* src, size_t w, size_t h,
+                                size_t begin, size_t end, byte* dst);
+
+    URBI_SDK_API void
+    nv12_to_grey8(const byte* src, size_t w, size_t h,
+                  size_t begin, size_t end, byte* dst);
+    URBI_SDK_API void
+    nv12_to_rgb(const byte* src, size_t w, size_t h,
+                size_t begin, size_t end, byte* dst);
+    URBI_SDK_API void
+    rgb_to_grey8(const byte* src, size_t w, size_t h,
+                 size_t begin, size_t end, byte* dst);
+    URBI_SDK_API void
+    yuv420_to_ycbcr(const byte* src, size_t w, size_t h,
+                    size_t begin, size_t end, byte* dst);
+    URBI_SDK_API void
+    yuv422_to_rgb(const byte* src, size_t w, size_t h,
+                  size_t begin, size_t end, byte* dst);
+
+    /// Reference implementations of the above, one pixel at a time.
+    URBI_SDK_API void
+    nv12_to_grey8_scalar(const byte* src, size_t w, size_t h,
+                         size_t begin, size_t end, byte* dst);
+    URBI_SDK_API void
+    nv12_to_rgb_scalar(const byte* src, size_t w, size_t h,
+                       size_t begin, size_t end, byte* dst);
+    URBI_SDK_API void
+    rgb_to_grey8_scalar(const byte* src, size_t w, size_t h,
+                        size_t begin, size_t end, byte* dst);
+    URBI_SDK_API void
+    yuv422_to_rgb_scalar(const byte* src, size_t w, size_t h,
+                         size_t begin, size_t end, byte* dst);
+  }
+}
+
+#endif // ! LIBURBI_IMAGE_KERNELS_HH
@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/image-scaling.cc
+/// \brief Implementation of urbi::image_scaling.
+
+#if defined __AVX2__
+# define URBI_IMAGE_SCALING_AVX2
+# include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && 2 <= _M_IX86_FP)
+# define URBI_IMAGE_SCALING_SSE2
+# include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <liburbi/image-scaling.hh>
+
+namespace urbi
+{
+  namespace image_scaling
+  {
+    namespace
+    {
+      /// The scaling is separable: each destination row is the
+      /// weighted sum of source rows (the vertical pass), kept with
+      /// row_bits bits of fraction, then resampled (the horizontal
+      /// pass).  The sums fit in 32 bits.
+      enum
+      {
+        row_bits = 7,
+        vertical_shift = Table::bits - row_bits,
+        horizontal_shift = Table::bits + row_bits,
+      };
+
+      /// The source samples of a destination sample, with their
+      /// weights.
+      typedef std::vector<std::pair<size_t, double> > samples_type;
+
+      inline void
+      add_sample(samples_type& s, size_t i, double w)
+      {
+        if (!s.empty() && s.back().first == i)
+          s.back().second += w;
+        else
+          s.push_back(std::make_pair(i, w));
+      }
+
+      /// Whether to average the samples covered, rather than
+      /// interpolate between the two nearest ones.
+      inline bool
+      area(size_t src, size_t dst, UScaleFilter filter)
+      {
+        return (filter == SCALE_AREA
+                || (filter == SCALE_AUTO && dst < src));
+      }
+
+      static Table*
+      make_table(size_t src, size_t dst, bool area)
+      {
+        std::vector<samples_type> samples(dst);
+        double ratio = double(src) / dst;
+        size_t taps = 1;
+        for (size_t i = 0; i < dst; ++i)
+        {
+          samples_type& s = samples[i];
+          if (area)
+          {
+            // The source samples under [b, e), in proportion of the
+            // part covered.
+            double b = i * ratio;
+            double e = (i + 1) * ratio;
+            for (size_t j = size_t(b); j < e && j < src; ++j)
+            {
+              double w = std::min(e, j + 1.) - std::max(b, double(j));
+              if (1e-9 < w)
+                add_sample(s, j, w);
+            }
+          }
+          else
+          {
+            // The two source samples around the center of i, the edges
+            // being repeated.
+            double c = (i + .5) * ratio - .5;
+            double f = floor(c);
+            long j = long(f);
+            long last = src - 1;
+            add_sample(s, std::max(0L, std::min(j, last)), 1 - (c - f));
+            add_sample(s, std::max(0L, std::min(j + 1, last)), c - f);
+          }
+          taps = std::max(taps, s.back().first - s.front().first + 1);
+        }
+
+        Table* res = new Table;
+        res->taps = taps;
+        res->first.resize(dst);
+        res->weights.resize(dst * taps, 0);
+        for (size_t i = 0; i < dst; ++i)
+        {
+          samples_type& s = samples[i];
+          double total = 0;
+          for (size_t k = 0; k < s.size(); ++k)
+            total += s[k].second;
+          // Quantize, and give the rounding error to the heaviest
+          // weight so that the sum is exactly one.
+          size_t first = std::min(s.front().first, src - taps);
+          short* w = &res->weights[i * taps];
+          int sum = 0;
+          size_t heaviest = 0;
+          for (size_t k = 0; k < s.size(); ++k)
+          {
+            size_t j = s[k].first - first;
+            w[j] = short(floor(s[k].second / total * Table::one + .5));
+            sum += w[j];
+            if (w[heaviest] < w[j])
+              heaviest = j;
+          }
+          w[heaviest] += Table::one - sum;
+          res->first[i] = first;
+        }
+        return res;
+      }
+
+      /// The tables computed so far.
+      typedef std::pair<std::pair<size_t, size_t>, bool> key_type;
+      typedef std::map<key_type, table_type> tables_type;
+      static tables_type tables;
+      static boost::mutex tables_mutex;
+
+      /// The result of the vertical pass, per thread, kept from one
+      /// image to the next.
+      static boost::thread_specific_ptr<std::vector<short> > rows;
+
+      /// The weighted sum of the \a taps rows of \a n samples from \a
+      /// src, \a stride bytes apart, in 1/2^row_bits.
+      static void
+      vertical_scalar(const byte* src, size_t stride, size_t n,
+                      const short* w, size_t taps, short* dst)
+      {
+        for (size_t i = 0; i < n; ++i)
+        {
+          int sum = 0;
+          for (size_t k = 0; k < taps; ++k)
+            sum += src[i + k * stride] * w[k];
+          dst[i] = (sum + (1 << (vertical_shift - 1))) >> vertical_shift;
+        }
+      }
+
+      /// Resample \a src, a row of \a channels interleaved samples per
+      /// pixel from the vertical pass, into \a dst.  \a Taps is
+      /// t.taps, or 0 if not known at compile time.
+      template <size_t Taps>
+      static void
+      horizontal_(const short* src, size_t channels, const Table& t,
+                  byte* dst)
+      {
+        size_t taps = Taps ? Taps : t.taps;
+        const short* w = &t.weights[0];
+        for (size_t x = 0, dw = t.first.size(); x < dw; ++x, w += taps)
+        {
+          const short* s = src + t.first[x] * channels;
+          for (size_t c = 0; c < channels; ++c)
+          {
+            int sum = 0;
+            for (size_t k = 0; k < taps; ++k)
+              sum += s[k * channels + c] * w[k];
+            *dst++ =
+              (sum + (1 << (horizontal_shift - 1))) >> horizontal_shift;
+          }
+        }
+      }
+
+      static void
+      horizontal(const short* src, size_t channels, const Table& t,
+                 byte* dst)
+      {
+        switch (t.taps)
+        {
+        case 1: horizontal_<1>(src, channels, t, dst); break;
+        case 2: horizontal_<2>(src, channels, t, dst); break;
+        case 3: horizontal_<3>(src, channels, t, dst); break;
+        default: horizontal_<0>(src, channels, t, dst); break;
+        }
+      }
+
+      typedef void (*vertical_type)(const byte* src, size_t stride,
+                                    size_t n, const short* w, size_t taps,
+                                    short* dst);
+
+      static void
+      scale_(vertical_type vertical,
+             const byte* src, size_t sw, size_t sh, size_t channels,
+             byte* dst, size_t dw, size_t dh, UScaleFilter filter,
+             size_t begin, size_t end)
+      {
+        if (!sw || !sh || !dw || !dh)
+          return;
+        table_type tx = table(sw, dw, filter);
+        table_type ty = table(sh, dh, filter);
+        size_t n = sw * channels;
+        if (!rows.get())
+          rows.reset(new std::vector<short>);
+        std::vector<short>& row = *rows;
+        if (row.size() < n)
+          row.resize(n);
+        for (size_t y = begin; y < end; ++y)
+        {
+          vertical(src + ty->first[y] * n, n, n,
+                   &ty->weights[y * ty->taps], ty->taps, &row[0]);
+          horizontal(&row[0], channels, *tx, dst + y * dw * channels);
+        }
+      }
+
+#if defined URBI_IMAGE_SCALING_AVX2 || defined URBI_IMAGE_SCALING_SSE2
+
+      /*-----------------------------------------------------------.
+      | The vertical pass, on 16-bit elements, two rows at a time  |
+      | with madd.  The unpack lo/hi are undone by the pack, which |
+      | keeps the samples in order, even in the lanes of AVX2.     |
+      `-----------------------------------------------------------*/
+
+# if defined URBI_IMAGE_SCALING_AVX2
+      typedef __m256i vec;
+#  define V(Op) _mm256_ ## Op
+
+      /// The \a block bytes from \a p, as 16-bit elements.
+      inline vec
+      widen(const byte* p)
+      {
+        return _mm256_cvtepu8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+      }
+
+      inline void
+      store(short* p, vec v)
+      {
+        _mm256_storeu_si256(reinterpret_cast<vec*>(p), v);
+      }
+# else
+      typedef __m128i vec;
+#  define V(Op) _mm_ ## Op
+
+      /// The \a block bytes from \a p, as 16-bit elements.
+      inline vec
+      widen(const byte* p)
+      {
+        return _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)),
+          _mm_setzero_si128());
+      }
+
+      inline void
+      store(short* p, vec v)
+      {
+        _mm_storeu_si128(reinterpret_cast<vec*>(p), v);
+      }
+# endif
+
+      /// The number of samples processed at once.
+      enum { block = sizeof(vec) / 2 };
+
+      /// The 32-bit elements made of \a lo and \a hi, for madd.
+      inline vec
+      pair(short lo, short hi)
+      {
+        return V(set1_epi32)(int(static_cast<unsigned short>(lo)
+                                 | static_cast<unsigned>(hi) << 16));
+      }
+
+      static void
+      vertical_simd(const byte* src, size_t stride, size_t n,
+                    const short* w, size_t taps, short* dst)
+      {
+        const vec round = V(set1_epi32)(1 << (vertical_shift - 1));
+        size_t i = 0;
+        for (; i + block <= n; i += block)
+        {
+          vec lo = V(set1_epi32)(0);
+          vec hi = lo;
+          for (size_t k = 0; k < taps; k += 2)
+          {
+            // An odd last tap is paired with itself, weighted 0.
+            bool odd = k + 1 == taps;
+            vec a = widen(src + k * stride + i);
+            vec b = odd ? a : widen(src + (k + 1) * stride + i);
+            vec ab = pair(w[k], odd ? 0 : w[k + 1]);
+            lo = V(add_epi32)(lo,
+                              V(madd_epi16)(V(unpacklo_epi16)(a, b), ab));
+            hi = V(add_epi32)(hi,
+                              V(madd_epi16)(V(unpackhi_epi16)(a, b), ab));
+          }
+          lo = V(srai_epi32)(V(add_epi32)(lo, round), vertical_shift);
+          hi = V(srai_epi32)(V(add_epi32)(hi, round), vertical_shift);
+          store(dst + i, V(packs_epi32)(lo, hi));
+        }
+        vertical_scalar(src + i, stride, n - i, w, taps, dst + i);
+      }
+
+# undef V
+#endif
+    }
+
+    const char*
+    flavor()
+    {
+#if defined URBI_IMAGE_SCALING_AVX2
+      return "avx2";
+#elif defined URBI_IMAGE_SCALING_SSE2
+      return "sse2";
+#else
+      return "scalar";
+#endif
+    }
+
+    table_type
+    table(size_t src, size_t dst, UScaleFilter filter)
+    {
+      bool a = area(src, dst, filter);
+      key_type key(std::make_pair(src, dst), a);
+      boost::mutex::scoped_lock lock(tables_mutex);
+      tables_type::iterator i = tables.find(key);
+      if (i != tables.end())
+        return i->second;
+      // A handful of sizes are used in practice; do not let unusual
+      // uses grow the cache forever.
+      if (64 <= tables.size())
+        tables.clear();
+      table_type res(make_table(src, dst, a));
+      tables[key] = res;
+      return res;
+    }
+
+    void
+    scale(const byte* src, size_t sw, size_t sh, size_t channels,
+          byte* dst, size_t dw, size_t dh, UScaleFilter filter,
+          size_t begin, size_t end)
+    {
+#if defined URBI_IMAGE_SCALING_AVX2 || defined URBI_IMAGE_SCALING_SSE2
+      scale_(vertical_simd,
+             src, sw, sh, channels, dst, dw, dh, filter, begin, end);
+#else
+      scale_(vertical_scalar,
+             src, sw, sh, channels, dst, dw, dh, filter, begin, end);
+#endif
+    }
+
+    void
+    scale_scalar(const byte* src, size_t sw, size_t sh, size_t channels,
+                 byte* dst, size_t dw, size_t dh, UScaleFilter filter,
+                 size_t begin, size_t end)
+    {
+      scale_(vertical_scalar,
+             src, sw, sh, channels, dst, dw, dh, filter, begin, end);
+    }
+  }
+}
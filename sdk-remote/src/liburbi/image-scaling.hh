@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/image-scaling.hh
+/// \brief Scaling of the planes of an image.
+
+#ifndef LIBURBI_IMAGE_SCALING_HH
+# define LIBURBI_IMAGE_SCALING_HH
+
+# include <cstddef>
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+
+# include <urbi/export.hh>
+# include <urbi/uconversion.hh>
+
+namespace urbi
+{
+  namespace image_scaling
+  {
+    /// The instruction set used by scale: "avx2", "sse2" or "scalar",
+    /// chosen at compile time.
+    URBI_SDK_API const char* flavor();
+
+    /// The resampling of a line of samples to another length.
+    struct URBI_SDK_API Table
+    {
+      /// The precision of the weights.
+      enum { bits = 14, one = 1 << bits };
+
+      /// The number of weights per destination sample.
+      size_t taps;
+      /// For each destination sample, the first source sample it
+      /// depends on.
+      std::vector<size_t> first;
+      /// For each destination sample, the weights of the taps source
+      /// samples from first, in 1/one, which sum to one.
+      std::vector<short> weights;
+    };
+
+    typedef boost::shared_ptr<const Table> table_type;
+
+    /// The table to resample \a src samples into \a dst with \a
+    /// filter.  Tables are computed once and cached.
+    URBI_SDK_API table_type
+    table(size_t src, size_t dst, UScaleFilter filter);
+
+    /// Scale the rows [\a begin, \a end) of \a dst, a \a dw x \a dh
+    /// plane, from \a src, a \a sw x \a sh plane, both of \a channels
+    /// interleaved bytes per pixel.  Different rows can be scaled
+    /// concurrently.
+    URBI_SDK_API void
+    scale(const byte* src, size_t sw, size_t sh, size_t channels,
+          byte* dst, size_t dw, size_t dh, UScaleFilter filter,
+          size_t begin, size_t end);
+
+    /// Reference implementation of scale, with the same results.
+    URBI_SDK_API void
+    scale_scalar(const byte* src, size_t sw, size_t sh, size_t channels,
+                 byte* dst, size_t dw, size_t dh, UScaleFilter filter,
+                 size_t begin, size_t end);
+  }
+}
+
+#endif // ! LIBURBI_IMAGE_SCALING_HH
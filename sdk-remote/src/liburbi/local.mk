@@ -14,9 +14,17 @@ lib_LTLIBRARIES += liburbi/liburbi@LIBSFX@.la
 # FIXME: Something is fishy here: why do we duplicate libuco code in
 # both liburbi and libuobject?  Libuobject includes liburbi.
 liburbi_liburbi@LIBSFX@_la_SOURCES =		\
+  liburbi/bands.cc				\
+  liburbi/bands.hh				\
   liburbi/compatibility.hh			\
   liburbi/compatibility.hxx			\
+  liburbi/image-kernels.cc			\
+  liburbi/image-kernels.hh			\
+  liburbi/image-scaling.cc			\
+  liburbi/image-scaling.hh			\
   liburbi/kernel-version.cc			\
+  liburbi/scanner.cc				\
+  liburbi/scanner.hh				\
   liburbi/uabstractclient.cc			\
   liburbi/uclient.cc				\
   liburbi/uconversion.cc			\
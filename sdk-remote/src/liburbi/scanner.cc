@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/scanner.cc
+/// \brief Implementation of urbi::scanner.
+
+#include <cctype>
+
+#if defined __AVX2__
+# include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && 2 <= _M_IX86_FP)
+# define URBI_SCANNER_SSE2
+# include <emmintrin.h>
+#endif
+#if defined _MSC_VER
+# include <intrin.h>
+#endif
+
+#include <liburbi/scanner.hh>
+
+namespace urbi
+{
+  namespace scanner
+  {
+    const char*
+    flavor()
+    {
+#if defined __AVX2__
+      return "avx2";
+#elif defined URBI_SCANNER_SSE2
+      return "sse2";
+#else
+      return "scalar";
+#endif
+    }
+
+    size_t
+    find_special_scalar(const char* s, size_t n)
+    {
+      for (size_t i = 0; i < n; ++i)
+        switch (s[i])
+        {
+        case '\n':
+        case '"':
+        case '[':
+        case ']':
+        case 'N':
+          return i;
+        }
+      return n;
+    }
+
+    size_t
+    find_string_special_scalar(const char* s, size_t n)
+    {
+      for (size_t i = 0; i < n; ++i)
+        if (s[i] == '\\' || s[i] == '"')
+          return i;
+      return n;
+    }
+
+#if defined __AVX2__ || defined URBI_SCANNER_SSE2
+    /// Index of the least significant bit set in \a mask, not 0.
+    static inline
+    size_t
+    first_bit(unsigned mask)
+    {
+# if defined _MSC_VER
+      unsigned long res;
+      _BitScanForward(&res, mask);
+      return res;
+# else
+      return __builtin_ctz(mask);
+# endif
+    }
+#endif
+
+    // Compare blocks of characters with each of the interesting ones
+    // at once, and use the mask of the matches to find the first one.
+    // The remainder, shorter than a block, is handled by the scalar
+    // code.
+#if defined __AVX2__
+# define BLOCK_TYPE      __m256i
+# define BLOCK_SIZE      32
+# define BLOCK_LOAD(P)   _mm256_loadu_si256(reinterpret_cast<const __m256i*>(P))
+# define BLOCK_SET(C)    _mm256_set1_epi8(C)
+# define BLOCK_EQ(A, B)  _mm256_cmpeq_epi8(A, B)
+# define BLOCK_OR(A, B)  _mm256_or_si256(A, B)
+# define BLOCK_MASK(A)   unsigned(_mm256_movemask_epi8(A))
+#elif defined URBI_SCANNER_SSE2
+# define BLOCK_TYPE      __m128i
+# define BLOCK_SIZE      16
+# define BLOCK_LOAD(P)   _mm_loadu_si128(reinterpret_cast<const __m128i*>(P))
+# define BLOCK_SET(C)    _mm_set1_epi8(C)
+# define BLOCK_EQ(A, B)  _mm_cmpeq_epi8(A, B)
+# define BLOCK_OR(A, B)  _mm_or_si128(A, B)
+# define BLOCK_MASK(A)   unsigned(_mm_movemask_epi8(A))
+#endif
+
+    size_t
+    find_special(const char* s, size_t n)
+    {
+      size_t i = 0;
+#if defined BLOCK_TYPE
+      const BLOCK_TYPE newline = BLOCK_SET('\n');
+      const BLOCK_TYPE quote = BLOCK_SET('"');
+      const BLOCK_TYPE open = BLOCK_SET('[');
+      const BLOCK_TYPE close = BLOCK_SET(']');
+      const BLOCK_TYPE bin = BLOCK_SET('N');
+      for (; i + BLOCK_SIZE <= n; i += BLOCK_SIZE)
+      {
+        BLOCK_TYPE b = BLOCK_LOAD(s + i);
+        BLOCK_TYPE m =
+          BLOCK_OR(BLOCK_OR(BLOCK_OR(BLOCK_EQ(b, newline),
+                                     BLOCK_EQ(b, quote)),
+                            BLOCK_OR(BLOCK_EQ(b, open),
+                                     BLOCK_EQ(b, close))),
+                   BLOCK_EQ(b, bin));
+        if (unsigned mask = BLOCK_MASK(m))
+          return i + first_bit(mask);
+      }
+#endif
+      return i + find_special_scalar(s + i, n - i);
+    }
+
+    size_t
+    find_string_special(const char* s, size_t n)
+    {
+      size_t i = 0;
+#if defined BLOCK_TYPE
+      const BLOCK_TYPE backslash = BLOCK_SET('\\');
+      const BLOCK_TYPE quote = BLOCK_SET('"');
+      for (; i + BLOCK_SIZE <= n; i += BLOCK_SIZE)
+      {
+        BLOCK_TYPE b = BLOCK_LOAD(s + i);
+        BLOCK_TYPE m = BLOCK_OR(BLOCK_EQ(b, backslash), BLOCK_EQ(b, quote));
+        if (unsigned mask = BLOCK_MASK(m))
+          return i + first_bit(mask);
+      }
+#endif
+      return i + find_string_special_scalar(s + i, n - i);
+    }
+
+    static inline
+    bool
+    is_tag_char(char c)
+    {
+      return (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z')
+              || ('0' <= c && c <= '9') || c == '_' || c == '.');
+    }
+
+    int
+    scan_header(const char* s, int& timestamp, char* tag, size_t tag_size)
+    {
+      // "[".
+      if (*s != '[')
+        return 0;
+      ++s;
+      // "%d".
+      while (isspace(static_cast<unsigned char>(*s)))
+        ++s;
+      bool negative = *s == '-';
+      if (*s == '-' || *s == '+')
+        ++s;
+      if (!isdigit(static_cast<unsigned char>(*s)))
+        return 0;
+      unsigned value = 0;
+      for (; isdigit(static_cast<unsigned char>(*s)); ++s)
+        value = value * 10 + (*s - '0');
+      timestamp = negative ? -int(value) : int(value);
+      // ":%63[A-Za-z0-9_.]".
+      if (*s != ':')
+        return 1;
+      ++s;
+      size_t n = 0;
+      while (n + 1 < tag_size && is_tag_char(s[n]))
+        ++n;
+      if (!n)
+        return 1;
+      for (size_t i = 0; i < n; ++i)
+        tag[i] = s[i];
+      tag[n] = 0;
+      return 2;
+    }
+  }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file liburbi/scanner.hh
+/// \brief Tokenization of the text protocol of the server.
+
+#ifndef LIBURBI_SCANNER_HH
+# define LIBURBI_SCANNER_HH
+
+# include <cstddef>
+
+# include <urbi/export.hh>
+
+namespace urbi
+{
+  namespace scanner
+  {
+    /// The instruction set used by the scanner: "avx2", "sse2" or
+    /// "scalar", chosen at compile time.
+    URBI_SDK_API const char* flavor();
+
+    /// Index of the first character in [\a s, \a s + \a n) that
+    /// matters to the parser out of a string: one of `\n', `"', `[',
+    /// `]', or the `N' of a possible "BIN ".  \a n if there is none.
+    URBI_SDK_API size_t find_special(const char* s, size_t n);
+
+    /// Likewise, in a string: one of `\\' and `"'.
+    URBI_SDK_API size_t find_string_special(const char* s, size_t n);
+
+    /// Reference implementations of the above, one character at a
+    /// time.
+    URBI_SDK_API size_t find_special_scalar(const char* s, size_t n);
+    URBI_SDK_API size_t find_string_special_scalar(const char* s, size_t n);
+
+    /// Parse the header of a message, "[timestamp:tag]" or
+    /// "[timestamp]", at \a s, a 0-terminated string.
+    ///
+    /// Same as trying sscanf(s, "[%d:%63[A-Za-z0-9_.]]") then
+    /// sscanf(s, "[%d]"), without parsing the formats each time.
+    ///
+    /// \param tag  receives the tag, of at most \a tag_size - 1
+    ///             characters, if there is one.
+    /// \return 2 if there is a timestamp and a tag, 1 if there is
+    ///   only a timestamp, 0 if there is none.
+    URBI_SDK_API int scan_header(const char* s, int& timestamp,
+                                 char* tag, size_t tag_size);
+  }
+}
+
+#endif // ! LIBURBI_SCANNER_HH
@@ -33,6 +33,7 @@
 #include <libport/unistd.h>
 #include <libport/windows.hh>
 
+#include <urbi/frame-pool.hh>
 #include <urbi/uabstractclient.hh>
 #include <urbi/uconversion.hh>
 #include <urbi/umessage.hh>
@@ -40,6 +41,7 @@
 #include <urbi/uclient.hh>
 
 #include <liburbi/compatibility.hh>
+#include <liburbi/scanner.hh>
 
 GD_CATEGORY(Urbi.Client.Abstract);
 
@@ -194,11 +196,13 @@ namespace urbi
 
     , recvBuffer(new char[buflen])
     , recvBufferPosition(0)
+    , recvBufferStart(0)
     , sendBuffer(new char[buflen])
 
     , kernelMajor_(-1)
     , kernelMinor_(-1)
     , binaryBuffer(0)
+    , binaryBufferCapacity(0)
     , parsePosition(0)
     , inString(false)
     , nBracket(0)
@@ -724,43 +728,42 @@ namespace urbi
     if (binaryBufferPosition == binaryBufferLength)
     {
       //Finished receiving binary.
-      //append
-      BinaryData bd;
-      bd.size = binaryBufferLength;
-      bd.data = binaryBuffer;
-      bins << bd;
+      //append, and let the message take the buffer.
+      bins << BinaryData(binaryBuffer, binaryBufferLength, true,
+                         binaryBufferCapacity);
       binaryBuffer = 0;
 
       if (nBracket == 0)
       {
         //end of command, send
+        // The payload was copied, end the text of the message there,
+        // so that it does not include it.  Beware of empty payloads,
+        // immediately followed by the next message.
+        if (len)
+          recvBuffer[endOfHeaderPosition] = 0;
         //dumb listLock.lock();
-        UMessage msg(*this, currentTimestamp, currentTag, currentCommand,
-                     bins);
+        UMessage msg(*this, currentTimestamp, currentTag,
+                     recvBuffer + currentCommand, bins);
         notifyCallbacks(msg);
         //unlistLock.lock();
 
         bins_clear();
 
-        //flush
-        parsePosition = 0;
-        //Move the extra we received
-        recvBufferPosition -= len + endOfHeaderPosition;
-        memmove(recvBuffer,
-                recvBuffer + endOfHeaderPosition + len,
-                recvBufferPosition);
+        // Skip the message, without moving what follows.
+        recv_buffer_consume_(endOfHeaderPosition + len);
       }
       else
       {
         // not over yet
         //leave parseposition where it is
-        //move the extra (parsePosition = endOfHeaderPosition)
+        //cut the binary data out of the message, whose text must
+        //be contiguous (parsePosition = endOfHeaderPosition)
         recvBufferPosition -= len;
         memmove(recvBuffer + parsePosition,
                 recvBuffer + endOfHeaderPosition + len,
                 recvBufferPosition - endOfHeaderPosition);
+        recvBuffer[recvBufferPosition] = 0;
       }
-      binaryBuffer = 0;
       binaryMode = false;
 
       // Reenter loop.
@@ -770,39 +773,56 @@ namespace urbi
     {
       // Not finished receiving binary.
       recvBufferPosition = endOfHeaderPosition;
+      recvBuffer[recvBufferPosition] = 0;
       return false;
     }
   }
 
+  void
+  UAbstractClient::recv_buffer_consume_(size_t pos)
+  {
+    recvBufferStart = parsePosition = pos;
+    // Everything was processed: start again at the beginning, for
+    // free.
+    if (recvBufferStart == recvBufferPosition)
+    {
+      recvBufferStart = parsePosition = recvBufferPosition = 0;
+      recvBuffer[0] = 0;
+    }
+  }
+
   bool
   UAbstractClient::process_recv_buffer_text_()
   {
     // Not in binary mode.
+    char* start = recvBuffer + recvBufferStart;
     char* endline =
       static_cast<char*> (memchr(recvBuffer+parsePosition, '\n',
                                  recvBufferPosition - parsePosition));
     if (!endline)
       return false; //no new end of command/start of binary: wait
 
-    if (parsePosition == 0) // parse header
+    if (parsePosition == recvBufferStart) // parse header
     {
       // Ignore empty lines.
-      if (endline == recvBuffer)
+      if (endline == start)
       {
-        memmove(recvBuffer, recvBuffer+1, recvBufferPosition - 1);
-        recvBufferPosition--;
+        recv_buffer_consume_(recvBufferStart + 1);
         return true;
       }
 
-      if (2 != sscanf(recvBuffer, "[%d:%64[A-Za-z0-9_.]]",
-                      &currentTimestamp, currentTag))
+      switch (scanner::scan_header(start, currentTimestamp,
+                                   currentTag, sizeof currentTag))
       {
-        if (1 == sscanf(recvBuffer, "[%d]", &currentTimestamp))
+        case 2:
+          break;
+        case 1:
           currentTag[0] = 0;
-        else
+          break;
+        default:
         {
           // failure
-          GD_FERROR("read, error parsing header: '%s'", recvBuffer);
+          GD_FERROR("read, error parsing header: '%s'", start);
           currentTimestamp = 0;
           strcpy(currentTag, "UNKNWN");
           //listLock.lock();
@@ -814,30 +834,38 @@ namespace urbi
         }
       }
 
-      currentCommand = strstr(recvBuffer, "]");
-      if (!currentCommand)
+      char* command = strchr(start, ']');
+      if (!command)
       {
         //reset all
         nBracket = 0;
         inString = false;
-        parsePosition = 0;
-        recvBufferPosition = 0;
+        recv_buffer_consume_(recvBufferPosition);
         return false;
       }
 
-      ++currentCommand;
-      while (*currentCommand == ' ')
-        ++currentCommand;
-      system = (*currentCommand == '!' || *currentCommand == '*');
-      parsePosition = (long) currentCommand - (long) recvBuffer;
+      ++command;
+      while (*command == ' ')
+        ++command;
+      system = (*command == '!' || *command == '*');
+      currentCommand = parsePosition = command - recvBuffer;
 
       //reinit just to be sure:
       nBracket = 0;
       inString = false;
     }
 
-    for (/* nothing */; parsePosition < recvBufferPosition; ++parsePosition)
+    while (parsePosition < recvBufferPosition)
     {
+      // Skip the characters that do not matter, by blocks.
+      const char* p = recvBuffer + parsePosition;
+      size_t left = recvBufferPosition - parsePosition;
+      parsePosition += (inString
+                        ? scanner::find_string_special(p, left)
+                        : scanner::find_special(p, left));
+      if (parsePosition == recvBufferPosition)
+        break;
+
       if (inString)
         switch (recvBuffer[parsePosition])
         {
@@ -845,10 +873,11 @@ namespace urbi
           if (parsePosition == recvBufferPosition-1)
             //we cant handle the '\\'
             return false;
-          ++parsePosition; //ignore next character
+          parsePosition += 2; //ignore next character
           continue;
         case '"':
           inString = false;
+          ++parsePosition;
           continue;
         }
       else
@@ -857,12 +886,15 @@ namespace urbi
         {
         case '"':
           inString = true;
+          ++parsePosition;
           continue;
         case '[':
           ++nBracket;
+          ++parsePosition;
           continue;
         case ']':
           --nBracket;
+          ++parsePosition;
           continue;
         case '\n':
           // FIXME: handle '[' in echoed messages or errors nBracket == 0.
@@ -871,44 +903,50 @@ namespace urbi
           recvBuffer[parsePosition] = 0;
           //listLock.lock();
           UMessage msg(*this, currentTimestamp, currentTag,
-                       currentCommand,
+                       recvBuffer + currentCommand,
                        bins);
           notifyCallbacks(msg);
           //unlistLock.lock();
-          //prepare for next read, copy the extra
-          memmove(recvBuffer, recvBuffer + parsePosition + 1,
-                  recvBufferPosition - parsePosition - 1);
-          // copy beginning of next cmd
-          recvBufferPosition = recvBufferPosition - parsePosition - 1;
-          recvBuffer[recvBufferPosition] = 0;
-          parsePosition = 0;
+          // Skip the message, without moving what follows.
+          recv_buffer_consume_(parsePosition + 1);
           bins_clear();
           goto line_finished; //restart
         }
 
-        if (!system && !strncmp(recvBuffer+parsePosition-3, "BIN ", 4))
+        // An `N', possibly that of "BIN ".
+        if (!system && recvBufferStart + 2 <= parsePosition
+            && !strncmp(recvBuffer+parsePosition-2, "BIN", 3))
         {
-          //very important: scan starts below current point
-          //compute length
-          char* endLength;
-          binaryBufferLength =
-            strtol(recvBuffer+parsePosition+1, &endLength, 0);
-          if (endLength == recvBuffer+parsePosition+1)
-          {
-            GD_ERROR("read, error parsing bin data length.");
-            recvBufferPosition = 0;
+          // Wait for the character after "BIN".
+          if (parsePosition == recvBufferPosition-1)
             return false;
+          if (recvBuffer[parsePosition+1] == ' ')
+          {
+            ++parsePosition;
+            //very important: scan starts below current point
+            //compute length
+            char* endLength;
+            binaryBufferLength =
+              strtol(recvBuffer+parsePosition+1, &endLength, 0);
+            if (endLength == recvBuffer+parsePosition+1)
+            {
+              GD_ERROR("read, error parsing bin data length.");
+              recv_buffer_consume_(recvBufferPosition);
+              return false;
+            }
+            //go to end of header
+            while (recvBuffer[parsePosition] !='\n')
+              ++parsePosition; //we now we will find a \n
+            ++parsePosition;
+            endOfHeaderPosition = parsePosition;
+            binaryMode = true;
+            binaryBuffer = frame_pool::acquire(binaryBufferLength,
+                                               binaryBufferCapacity);
+            binaryBufferPosition = 0;
+            goto line_finished; //restart in binarymode to handle binary
           }
-          //go to end of header
-          while (recvBuffer[parsePosition] !='\n')
-            ++parsePosition; //we now we will find a \n
-          ++parsePosition;
-          endOfHeaderPosition = parsePosition;
-          binaryMode = true;
-          binaryBuffer = malloc(binaryBufferLength);
-          binaryBufferPosition = 0;
-          break; //restart in binarymode to handle binary
         }
+        ++parsePosition;
       }
     }
   line_finished:
@@ -916,6 +954,60 @@ namespace urbi
     return parsePosition != recvBufferPosition;
   }
 
+  void
+  UAbstractClient::recv_buffer_reserve_(size_t length)
+  {
+    if (length < recvBufSize - recvBufferPosition)
+      return;
+    // First reclaim the room of the processed messages, which is
+    // the only copy of the text received, and at most once per read.
+    if (recvBufferStart)
+    {
+      memmove(recvBuffer, recvBuffer + recvBufferStart,
+              recvBufferPosition - recvBufferStart);
+      recvBufferPosition -= recvBufferStart;
+      parsePosition -= recvBufferStart;
+      currentCommand -= std::min(currentCommand, recvBufferStart);
+      endOfHeaderPosition -= std::min(endOfHeaderPosition, recvBufferStart);
+      recvBufferStart = 0;
+      recvBuffer[recvBufferPosition] = 0;
+      if (length < recvBufSize - recvBufferPosition)
+        return;
+    }
+    size_t nsz = std::max(recvBufSize*2, recvBufferPosition + length+1);
+    char* nbuf = new char[nsz];
+    memcpy(nbuf, recvBuffer, recvBufferPosition + 1);
+    delete[] recvBuffer;
+    recvBuffer = nbuf;
+    recvBufSize = nsz;
+  }
+
+  void
+  UAbstractClient::recvData(const char* data, size_t length)
+  {
+    // The payload of a binary goes straight to its buffer, unless some
+    // of it is already in recvBuffer.
+    if (binaryMode && recvBufferPosition == endOfHeaderPosition)
+    {
+      size_t len = std::min(length, binaryBufferLength - binaryBufferPosition);
+      if (binaryBuffer)
+        memcpy(static_cast<char*>(binaryBuffer) + binaryBufferPosition,
+               data, len);
+      binaryBufferPosition += len;
+      data += len;
+      length -= len;
+      if (binaryBufferPosition == binaryBufferLength)
+        processRecvBuffer();
+      if (!length)
+        return;
+    }
+    recv_buffer_reserve_(length);
+    memcpy(recvBuffer + recvBufferPosition, data, length);
+    recvBufferPosition += length;
+    recvBuffer[recvBufferPosition] = 0;
+    processRecvBuffer();
+  }
+
   /*!
     As long as this function has not returned, neither recvBuffer
     nor recvBufferPos may be modified.
@@ -184,8 +184,6 @@ namespace urbi
   size_t
   UClient::onRead(const void* data, size_t length)
   {
-    size_t capacity = recvBufSize - recvBufferPosition - 1;
-
     if (ping_interval_ && ping_sem_.uget(1))
     {
       pong_timeout_handler_->cancel();
@@ -194,19 +192,7 @@ namespace urbi
                                        this, link_),
                            ping_interval_ - (libport::utime() - ping_sent_));
     }
-    if (capacity < length)
-    {
-      size_t nsz = std::max(recvBufSize*2, recvBufferPosition + length+1);
-      char* nbuf = new char[nsz];
-      memcpy(nbuf, recvBuffer, recvBufferPosition);
-      delete[] recvBuffer;
-      recvBuffer = nbuf;
-      recvBufSize = nsz;
-    }
-    memcpy(&recvBuffer[recvBufferPosition], data, length);
-    recvBufferPosition += length;
-    recvBuffer[recvBufferPosition] = 0;
-    processRecvBuffer();
+    recvData(static_cast<const char*>(data), length);
     return length;
   }
 
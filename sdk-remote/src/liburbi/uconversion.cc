@@ -14,7 +14,13 @@
 #include <libport/cstdio>
 #include <libport/format.hh>
 
+#include <boost/ref.hpp>
+
+#include <urbi/frame-pool.hh>
 #include <urbi/uconversion.hh>
+#include <liburbi/bands.hh>
+#include <liburbi/image-kernels.hh>
+#include <liburbi/image-scaling.hh>
 
 GD_CATEGORY(Urbi.Convert);
 
@@ -24,6 +30,8 @@ GD_CATEGORY(Urbi.Convert);
 #ifndef NO_IMAGE_CONVERSION
 # include <csetjmp>
 
+# include <boost/thread/tss.hpp>
+
 // It would be nice to use jpeg/jpeglib.h, but this file includes
 // jconfig.h, unqualified, which we might pick-up on the host.  So
 // don't take gratuitous chances.
@@ -34,9 +42,10 @@ namespace urbi
 
   namespace
   {
-    void*
-    read_jpeg(const char* jpgbuffer, size_t jpgbuffer_size,
-              bool RGB, size_t& output_size, size_t& w, size_t& h);
+    bool
+    read_jpeg(const byte* jpgbuffer, size_t jpgbuffer_size, bool RGB,
+              size_t min_w, size_t min_h, byte*& buffer, size_t& capacity,
+              size_t& output_size, size_t& w, size_t& h);
 
     int
     write_jpeg(const byte* src, size_t w, size_t h, bool ycrcb,
@@ -153,16 +162,18 @@ namespace urbi
       return 0;
 
     size_t sz;
-    void *destination = read_jpeg((const char*) source, sourcelen,
-                                  dest_format == IMAGE_RGB, sz, w, h);
-    if (!destination)
+    byte* destination = 0;
+    size_t capacity = 0;
+    if (!read_jpeg(source, sourcelen, dest_format == IMAGE_RGB, 0, 0,
+                   destination, capacity, sz, w, h))
     {
+      free(destination);
       size = 0;
       return 0;
     }
     if (!*dest)
     {
-      *dest = (byte*) destination;
+      *dest = destination;
       size = sz;
       return 1;
     }
@@ -304,27 +315,83 @@ namespace urbi
 
   namespace
   {
+    /// The libjpeg objects of a thread, set up once and reused from
+    /// one image to the next.
+    struct JpegContext
+    {
+      JpegContext()
+        : buffer(0)
+        , capacity(0)
+      {
+        decompress.err = jpeg_std_error(&decompress_error.pub);
+        decompress_error.pub.error_exit = urbi_jpeg_error_exit;
+        jpeg_create_decompress(&decompress);
+        decompress.src = &source.pub;
+        source.pub.skip_input_data = skip_input_data;
+        source.pub.term_source = term_source;
+        source.pub.init_source = init_source;
+        source.pub.fill_input_buffer = fill_input_buffer;
+        source.pub.resync_to_restart = jpeg_resync_to_restart;
+
+        compress.err = jpeg_std_error(&compress_error.pub);
+        compress_error.pub.error_exit = urbi_jpeg_error_exit;
+        jpeg_create_compress(&compress);
+        compress.dest = &destination.pub;
+        destination.pub.init_destination = init_destination;
+        destination.pub.empty_output_buffer = empty_output_buffer;
+        destination.pub.term_destination = term_destination;
+      }
+
+      ~JpegContext()
+      {
+        jpeg_destroy_decompress(&decompress);
+        jpeg_destroy_compress(&compress);
+        free(buffer);
+      }
+
+      jpeg_decompress_struct decompress;
+      urbi_jpeg_error_mgr decompress_error;
+      mem_source_mgr source;
+
+      jpeg_compress_struct compress;
+      urbi_jpeg_error_mgr compress_error;
+      mem_destination_mgr destination;
+
+      /// The images decoded for convert, which do not outlive it.
+      byte* buffer;
+      size_t capacity;
+    };
+
+    static boost::thread_specific_ptr<JpegContext> jpeg_contexts;
+
+    /// The JpegContext of the calling thread.
+    static JpegContext&
+    jpeg_context()
+    {
+      if (!jpeg_contexts.get())
+        jpeg_contexts.reset(new JpegContext);
+      return *jpeg_contexts;
+    }
+
     int
     write_jpeg(const byte* src, size_t w, size_t h, bool ycrcb,
                byte* dst, size_t& sz, int quality)
     {
-      struct jpeg_compress_struct cinfo;
-      struct jpeg_error_mgr jerr;
+      JpegContext& context = jpeg_context();
+      jpeg_compress_struct& cinfo = context.compress;
+      if (setjmp(context.compress_error.setjmp_buffer))
+      {
+        // Leave the object ready for the next image.
+        jpeg_abort_compress(&cinfo);
+        GD_ERROR("JPEG error!");
+        sz = 0;
+        return 0;
+      }
 
       int row_stride;		/* physical row width in image buffer */
 
-      cinfo.err = jpeg_std_error(&jerr);
-      jpeg_create_compress(&cinfo);
-      mem_destination_mgr *dest = (struct mem_destination_mgr *)
-        (*cinfo.mem->alloc_small) ((j_common_ptr) & cinfo, JPOOL_PERMANENT,
-                                   sizeof (mem_destination_mgr));
-
-      cinfo.dest = (jpeg_destination_mgr*)dest;
-      dest->pub.init_destination=&init_destination;
-      dest->pub.empty_output_buffer = &empty_output_buffer;
-      dest->pub.term_destination = term_destination;
-      dest->pub.free_in_buffer = sz;
-      dest->pub.next_output_byte = dst;
+      context.destination.pub.free_in_buffer = sz;
+      context.destination.pub.next_output_byte = dst;
       cinfo.image_width = w;
       cinfo.image_height = h;
       cinfo.input_components = 3;  // # of color components per pixel.
@@ -349,53 +416,59 @@ namespace urbi
       }
 
       jpeg_finish_compress(&cinfo);
-      sz -= dest->pub.free_in_buffer ;
-      jpeg_destroy_compress(&cinfo);
+      sz -= context.destination.pub.free_in_buffer;
 
       return sz;
     }
 
-    /*! Convert a jpeg image to YCrCb or RGB. Allocate the buffer with malloc.
+    /*! Convert a jpeg image to YCrCb or RGB, in \a buffer, of \a
+     *  capacity bytes, reallocated with realloc if too small.
+     *
+     *  The DCT scales the image down to 1/2, 1/4 or 1/8 while it
+     *  remains at least \a min_w x \a min_h, if they are not null,
+     *  which is much cheaper than decoding it at full size.
      */
-    void *read_jpeg(const char* jpgbuffer, size_t jpgbuffer_size, bool RGB,
-                    size_t& output_size, size_t& w, size_t& h)
+    bool
+    read_jpeg(const byte* jpgbuffer, size_t jpgbuffer_size, bool RGB,
+              size_t min_w, size_t min_h, byte*& buffer, size_t& capacity,
+              size_t& output_size, size_t& w, size_t& h)
     {
-      struct jpeg_decompress_struct cinfo;
-      struct urbi_jpeg_error_mgr jerr;
-      cinfo.err = jpeg_std_error(&jerr.pub);
-      jerr.pub.error_exit = urbi_jpeg_error_exit;
-      if (setjmp(jerr.setjmp_buffer))
+      JpegContext& context = jpeg_context();
+      jpeg_decompress_struct& cinfo = context.decompress;
+      if (setjmp(context.decompress_error.setjmp_buffer))
       {
-        /* If we get here, the JPEG code has signaled an error.  We
-         * need to clean up the JPEG object, close the input file, and
-         * return.
+        /* If we get here, the JPEG code has signaled an error.  Leave
+         * the object ready for the next image, and return.
          */
-        jpeg_destroy_decompress(&cinfo);
+        jpeg_abort_decompress(&cinfo);
         GD_ERROR("JPEG error!");
-        return 0;
+        return false;
       }
-      jpeg_create_decompress(&cinfo);
-      mem_source_mgr *source = (struct mem_source_mgr *)
-        (*cinfo.mem->alloc_small) ((j_common_ptr) & cinfo, JPOOL_PERMANENT,
-                                   sizeof (mem_source_mgr));
-
-      cinfo.src = (jpeg_source_mgr *) source;
-      source->pub.skip_input_data = skip_input_data;
-      source->pub.term_source = term_source;
-      source->pub.init_source = init_source;
-      source->pub.fill_input_buffer = fill_input_buffer;
-      source->pub.resync_to_restart = jpeg_resync_to_restart;
-      source->pub.bytes_in_buffer = jpgbuffer_size;
-      source->pub.next_input_byte = (JOCTET *) jpgbuffer;
-      cinfo.out_color_space = (RGB ? JCS_RGB : JCS_YCbCr);
+      context.source.pub.bytes_in_buffer = jpgbuffer_size;
+      context.source.pub.next_input_byte = jpgbuffer;
       jpeg_read_header(&cinfo, TRUE);
       cinfo.out_color_space = (RGB ? JCS_RGB : JCS_YCbCr);
+      cinfo.scale_num = 1;
+      cinfo.scale_denom = 1;
+      if (min_w && min_h)
+        for (unsigned d = 2; d <= 8; d *= 2)
+        {
+          // libjpeg rounds the scaled sizes up.
+          if ((cinfo.image_width + d - 1) / d < min_w
+              || (cinfo.image_height + d - 1) / d < min_h)
+            break;
+          cinfo.scale_denom = d;
+        }
       jpeg_start_decompress(&cinfo);
       w = cinfo.output_width;
       h = cinfo.output_height;
       output_size =
         cinfo.output_width * cinfo.output_components * cinfo.output_height;
-      void *buffer = malloc(output_size);
+      if (capacity < output_size)
+      {
+        buffer = static_cast<byte*>(realloc(buffer, output_size));
+        capacity = output_size;
+      }
 
       while (cinfo.output_scanline < cinfo.output_height)
       {
@@ -404,53 +477,123 @@ namespace urbi
          * more than one scanline at a time if that's more convenient.
          */
         JSAMPLE* row =
-          (JSAMPLE *) &((char*) buffer)[cinfo.output_scanline
-                                        * cinfo.output_components
-                                        * cinfo.output_width];
+          (JSAMPLE *) &buffer[cinfo.output_scanline
+                              * cinfo.output_components
+                              * cinfo.output_width];
         jpeg_read_scanlines(&cinfo, &row, 1);
       }
       jpeg_finish_decompress(&cinfo);
-      jpeg_destroy_decompress(&cinfo);
 
-      return buffer;
+      return true;
     }
 
 
 
-    //scale putting (scx, scy) at the center of destination image
-    void scaleColorImage(byte* src, int sw, int sh,
-                         int scx, int scy, byte* dst,
-                         int dw, int dh, ufloat sx, ufloat sy)
+    /*-------------------------------------------------------------.
+    | The steps of convert, as jobs on row bands (see bands::run).  |
+    `-------------------------------------------------------------*/
+
+    /// image_scaling::scale.
+    struct ScaleJob
+    {
+      const byte* src;
+      size_t sw, sh, channels;
+      byte* dst;
+      size_t dw, dh;
+      UScaleFilter filter;
+
+      void operator()(size_t begin, size_t end) const
+      {
+        image_scaling::scale(src, sw, sh, channels, dst, dw, dh, filter,
+                             begin, end);
+      }
+    };
+
+    /// A pixel by pixel conversion of a buffer, such as
+    /// convertRGBtoYCbCr.
+    struct BufferJob
+    {
+      typedef int (*function_type)(const byte*, size_t, byte*);
+      function_type function;
+      const byte* src;
+      // The sizes of a row.
+      size_t src_row;
+      byte* dst;
+      size_t dst_row;
+
+      void operator()(size_t begin, size_t end) const
+      {
+        function(src + begin * src_row, (end - begin) * src_row,
+                 dst + begin * dst_row);
+      }
+    };
+
+    /// The packing of a pivot image into a planar format.
+    struct PlanarJob
     {
-      for (int x = 0; x < dw; ++x)
-        for (int y = 0; y < dh; ++y)
+      UImageFormat format;
+      const byte* pivot;
+      byte* dest;
+      unsigned int width, height;
+
+      void operator()(size_t begin, size_t end) const
+      {
+        unsigned int plane = width * height;
+        for (unsigned int i = begin * width; i < end * width; ++i)
+          dest[i] = pivot[i * 3];
+        switch (format)
         {
-          //find the corresponding point in source image
-          ufloat fsrcx = (ufloat) (x-dw/2) / sx  + (ufloat) scx;
-          ufloat fsrcy = (ufloat) (y-dh/2) / sy  + (ufloat) scy;
-          int srcx = (int) fsrcx;
-          int srcy = (int) fsrcy;
-          if (srcx <= 0 || srcx >= sw - 1 || srcy <= 0 || srcy >= sh - 1)
-            memset(dst + (x + y * dw) * 3, 0, 3);
-          else //do the bilinear interpolation
-          {
-            ufloat xfactor = fsrcx - (ufloat) srcx;
-            ufloat yfactor = fsrcy - (ufloat) srcy;
-            for (int color = 0; color < 3; ++color)
+        case IMAGE_YUV411_PLANAR:
+          for (unsigned int y = begin; y < end; y++)
+            for (unsigned int x = 0; x < width; x += 4)
+            {
+              dest[plane + x / 4 + y * width / 4]
+                = pivot[(x + y * width) * 3 + 1];
+              dest[plane+plane / 4 + x / 4 + y * width / 4]
+                = pivot[(x + y * width) * 3 + 2];
+            }
+          break;
+        case IMAGE_YUV420_PLANAR:
+          // begin is even.
+          for (unsigned int y = begin / 2; y < end / 2; y++)
+            for (unsigned int x = 0; x < width / 2; x++)
+            {
+              dest[plane + x + y * width / 2]
+                = pivot[(x * 2 + y * 2 * width) * 3 + 1];
+              dest[plane + plane/4 + x + y * width / 2]
+                = pivot[(x * 2 + y * 2 * width) * 3 + 2];
+            }
+          break;
+        case IMAGE_NV12:
+          // crcb interleaved plane, begin is even.
+          for (unsigned int y = begin; y < end; y += 2)
+            for (unsigned int x = 0; x < width; x += 2)
             {
-              ufloat up = (ufloat) src[(srcx + srcy * sw) * 3 + color]
-                * (1.0 - xfactor)
-                + (ufloat) src[(srcx + 1 + srcy * sw) * 3 + color] * xfactor;
-              ufloat down = (ufloat) src[(srcx + (srcy + 1) * sw) * 3 + color]
-                * (1.0 - xfactor)
-                + (ufloat) src[(srcx + 1 + (srcy + 1) * sw) * 3 + color]
-                * xfactor;
-              ufloat result = up * (1.0 - yfactor) + down * yfactor;
-              dst[(x + y * dw) * 3 + color] = (byte) result;
+              dest[plane + x + y * width / 2]
+                = pivot[(x + y * width) * 3 + 1];
+              dest[plane + x + y * width / 2 + 1]
+                = pivot[(x + y * width) * 3 + 2];
             }
-          }
+          break;
+        default:
+          break;
         }
-    }
+      }
+    };
+
+    /// An image_kernels conversion, see convert_direct.
+    struct DirectJob
+    {
+      image_kernels::kernel_type kernel;
+      const byte* src;
+      size_t width, height;
+      byte* dest;
+
+      void operator()(size_t begin, size_t end) const
+      {
+        kernel(src, width, height, begin, end, dest);
+      }
+    };
 
   } // anonymous namespace
 
@@ -467,7 +610,17 @@ namespace urbi
       aver(!data);
       allocated = true;
       size = s;
-      data = (byte*) malloc(size);
+      data = (byte*) frame_pool::acquire(size, capacity);
+    }
+
+    /// Give data back to the frame pool, if it was allocated.
+    void
+    release()
+    {
+      if (allocated)
+        frame_pool::release(data, capacity);
+      allocated = false;
+      data = 0;
     }
 
     void
@@ -484,8 +637,14 @@ namespace urbi
     typedef void (PivotImage::*conversion_type) (const UImage& src);
     static conversion_type converters[IMAGE_END][IMAGE_END];
 
-    // Whether data must be freed.
+    // Whether data must be released, and its capacity.
     bool allocated;
+    size_t capacity;
+
+    // The size the image is to be scaled to, if known: the
+    // converters may produce a smaller image, as long as it is
+    // larger than this.
+    size_t min_width, min_height;
 
     static bool converters_set;
   };
@@ -538,12 +697,14 @@ namespace urbi
   void
   PivotImage::convert_<IMAGE_JPEG, IMAGE_RGB>(const UImage& src)
   {
-    // This image is allocated by the function convertJPEG*
-    // function.  width, height and size are defined by these
-    // functions calls.
-    convertJPEGtoRGB(src.data, src.size,
-                     &data, size, width, height);
-    allocated = true;
+    // Decoded in the buffer of the thread, which is reused, and
+    // possibly scaled down.  width, height and size are defined by
+    // read_jpeg.
+    JpegContext& c = jpeg_context();
+    if (read_jpeg(src.data, src.size, true, min_width, min_height,
+                  c.buffer, c.capacity, size, width, height))
+      data = c.buffer;
+    allocated = false;
     imageFormat = IMAGE_RGB;
   }
 
@@ -551,9 +712,11 @@ namespace urbi
   void
   PivotImage::convert_<IMAGE_JPEG, IMAGE_YCbCr>(const UImage& src)
   {
-    convertJPEGtoYCrCb(src.data, src.size,
-                       &data, size, width, height);
-    allocated = true;
+    JpegContext& c = jpeg_context();
+    if (read_jpeg(src.data, src.size, false, min_width, min_height,
+                  c.buffer, c.capacity, size, width, height))
+      data = c.buffer;
+    allocated = false;
     imageFormat = IMAGE_YCbCr;
   }
 
@@ -588,8 +751,8 @@ namespace urbi
     unsigned char* cy = src.data;
     unsigned char* u = cy + w * h;
     unsigned char* v = u + w * h / 4;
-    for (size_t x = 0; x < w; ++x)
-      for (size_t y = 0; y < h; ++y)
+    for (size_t y = 0; y < h; ++y)
+      for (size_t x = 0; x < w; ++x)
       {
         data[(x + y * w) * 3 + 0] = cy[x + y * w];
         data[(x + y * w) * 3 + 1] = u[x / 4 + y * w / 4];
@@ -609,8 +772,8 @@ namespace urbi
     unsigned char* cy = src.data;
     unsigned char* u = cy + w * h;
     unsigned char* v = u + w * h / 4;
-    for (size_t x = 0; x < w; ++x)
-      for (size_t y = 0; y < h; ++y)
+    for (size_t y = 0; y < h; ++y)
+      for (size_t x = 0; x < w; ++x)
       {
         data[(x + y * w) * 3 + 0] = cy[x + y * w];
         data[(x + y * w) * 3 + 1] = u[x / 2 + (y >> 1) * w / 2];
@@ -629,8 +792,8 @@ namespace urbi
     alloc(w * h * 3);
     unsigned char* cy = src.data;
     unsigned char* uv = src.data + w * h;
-    for (size_t x = 0; x < w; ++x)
-      for (size_t y = 0; y < h; ++y)
+    for (size_t y = 0; y < h; ++y)
+      for (size_t x = 0; x < w; ++x)
       {
         data[(x + y * w) * 3 + 0] = cy[x + y * w];
         data[(x + y * w) * 3 + 1] = uv[((x >> 1) + (((y >> 1) * w) >> 1)) * 2];
@@ -671,6 +834,9 @@ namespace urbi
 
   PivotImage::PivotImage()
     : allocated(false)
+    , capacity(0)
+    , min_width(0)
+    , min_height(0)
   {
     if (!converters_set)
     {
@@ -753,8 +919,236 @@ namespace urbi
     }
   }
 
+  /*-------------------------------------------------------------.
+  | Direct conversions, without pivot image, of the common pairs. |
+  `-------------------------------------------------------------*/
+
+  namespace
+  {
+    struct DirectConverter
+    {
+      image_kernels::kernel_type kernel;
+      // The sizes of the source and destination images, in bytes per
+      // pair of pixels.
+      size_t src_size;
+      size_t dest_size;
+    };
+
+    static DirectConverter direct_converters[IMAGE_END][IMAGE_END];
+    static bool direct_converters_set = false;
+
+    static void
+    direct_converters_init()
+    {
+      if (direct_converters_set)
+        return;
+      for (int i = 0; i < IMAGE_END; ++i)
+        for (int j = 0; j < IMAGE_END; ++j)
+          direct_converters[i][j].kernel = 0;
+#define CASE(From, To, Kernel, SrcSize, DestSize)                       \
+      do {                                                              \
+        DirectConverter& c = direct_converters[IMAGE_ ## From][IMAGE_ ## To]; \
+        c.kernel = &image_kernels::Kernel;                              \
+        c.src_size = SrcSize;                                           \
+        c.dest_size = DestSize;                                         \
+      } while (false)
+      CASE(NV12,          GREY8, nv12_to_grey8,   3, 2);
+      CASE(NV12,          RGB,   nv12_to_rgb,     3, 6);
+      CASE(RGB,           GREY8, rgb_to_grey8,    6, 2);
+      CASE(YUV420_PLANAR, YCbCr, yuv420_to_ycbcr, 3, 6);
+      CASE(YUV422,        RGB,   yuv422_to_rgb,   4, 6);
+#undef CASE
+      direct_converters_set = true;
+    }
+
+    /// Convert \a src into \a dest in a single pass, if there is a
+    /// direct converter for their formats, and the image is not
+    /// resized.  Same results as the conversion through the pivot.
+    /// \return whether the conversion was made.
+    static bool
+    convert_direct(const UImage& src, UImage& dest,
+                   const ConversionPolicy& policy)
+    {
+      direct_converters_init();
+      const DirectConverter& c =
+        direct_converters[src.imageFormat][dest.imageFormat];
+      size_t w = src.width;
+      size_t h = src.height;
+      size_t pairs = w * h / 2;
+      if (!c.kernel
+          || !pairs
+          || (dest.width && dest.width != w)
+          || (dest.height && dest.height != h)
+          || w % 2 || h % 2
+          || src.size < pairs * c.src_size)
+        return false;
+      dest.width = w;
+      dest.height = h;
+      dest.size = pairs * c.dest_size;
+      dest.data = static_cast<byte*> (realloc(dest.data, dest.size));
+      DirectJob job = { c.kernel, src.data, w, h, dest.data };
+      bands::run(h, boost::ref(job), policy.threads, policy.band_rows);
+      return true;
+    }
+
+    /*-----------------------------------------------------.
+    | Scaling of the raw formats, plane by plane, without  |
+    | pivot image.                                         |
+    `-----------------------------------------------------*/
+
+    /// A plane of an image: its size is that of the image divided by
+    /// x_div and y_div, and it has channels bytes per pixel.
+    struct Plane
+    {
+      size_t x_div, y_div, channels;
+    };
+
+    /// The planes of the images in \a format, stored in \a planes.
+    /// \return their number, 0 if \a format cannot be scaled this way.
+    static size_t
+    image_planes(UImageFormat format, Plane planes[3])
+    {
+      static const Plane luma = { 1, 1, 1 };
+      switch (format)
+      {
+      case IMAGE_GREY8:
+        planes[0] = luma;
+        return 1;
+      case IMAGE_RGB:
+      case IMAGE_YCbCr:
+      {
+        static const Plane p = { 1, 1, 3 };
+        planes[0] = p;
+        return 1;
+      }
+      case IMAGE_NV12:
+      {
+        static const Plane uv = { 2, 2, 2 };
+        planes[0] = luma;
+        planes[1] = uv;
+        return 2;
+      }
+      case IMAGE_YUV411_PLANAR:
+      case IMAGE_YUV420_PLANAR:
+      {
+        static const Plane p411 = { 4, 1, 1 };
+        static const Plane p420 = { 2, 2, 1 };
+        planes[0] = luma;
+        planes[1] = planes[2] = (format == IMAGE_YUV411_PLANAR
+                                 ? p411 : p420);
+        return 3;
+      }
+      default:
+        return 0;
+      }
+    }
+
+    /// Scale \a src into \a dest, of the same format, if it is a raw
+    /// format whose planes can be scaled separately.
+    /// \param capacity  if not 0, dest.data is not allocated yet, and
+    ///                   is taken from the frame pool, with the
+    ///                   capacity stored there.
+    /// \return whether the image was scaled.
+    static bool
+    scale_direct(const UImage& src, UImage& dest,
+                 const ConversionPolicy& policy, size_t* capacity = 0)
+    {
+      Plane planes[3];
+      size_t n = image_planes(src.imageFormat, planes);
+      size_t sw = src.width;
+      size_t sh = src.height;
+      size_t dw = dest.width;
+      size_t dh = dest.height;
+      if (!n || !sw || !sh || !dw || !dh)
+        return false;
+      size_t src_size = 0;
+      size_t dest_size = 0;
+      for (size_t i = 0; i < n; ++i)
+      {
+        const Plane& p = planes[i];
+        if (sw % p.x_div || sh % p.y_div || dw % p.x_div || dh % p.y_div)
+          return false;
+        src_size += sw / p.x_div * sh / p.y_div * p.channels;
+        dest_size += dw / p.x_div * dh / p.y_div * p.channels;
+      }
+      if (src.size < src_size)
+        return false;
+
+      dest.imageFormat = src.imageFormat;
+      dest.size = dest_size;
+      if (capacity)
+        dest.data =
+          static_cast<byte*>(frame_pool::acquire(dest.size, *capacity));
+      else
+        dest.data = static_cast<byte*> (realloc(dest.data, dest.size));
+      const byte* s = src.data;
+      byte* d = dest.data;
+      for (size_t i = 0; i < n; ++i)
+      {
+        const Plane& p = planes[i];
+        ScaleJob job =
+          {
+            s, sw / p.x_div, sh / p.y_div, p.channels,
+            d, dw / p.x_div, dh / p.y_div, policy.filter
+          };
+        bands::run(job.dh, boost::ref(job),
+                   policy.threads, policy.band_rows, 1);
+        s += job.sw * job.sh * job.channels;
+        d += job.dw * job.dh * job.channels;
+      }
+      return true;
+    }
+  }
+
+  ConversionPolicy::ConversionPolicy(size_t t, size_t b, UScaleFilter f)
+    : threads(t)
+    , band_rows(b)
+    , filter(f)
+    , jpeg_quality(80)
+  {}
+
   int convert(const UImage& src, UImage& dest)
   {
+    return convert(src, dest, ConversionPolicy());
+  }
+
+  int convert(const UImage& src, UImage& dest,
+              const ConversionPolicy& policy)
+  {
+    if (convert_direct(src, dest, policy))
+      return 1;
+
+    // Scale the raw formats first, so that the conversion works on
+    // the scaled image, without pivot.
+    if ((dest.width && dest.width != src.width)
+        || (dest.height && dest.height != src.height))
+    {
+      UImage scaled;
+      scaled.width = dest.width ? dest.width : src.width;
+      scaled.height = dest.height ? dest.height : src.height;
+      if (src.imageFormat == dest.imageFormat)
+      {
+        UImage res(dest);
+        res.width = scaled.width;
+        res.height = scaled.height;
+        if (scale_direct(src, res, policy))
+        {
+          dest = res;
+          return 1;
+        }
+      }
+      else
+      {
+        size_t capacity;
+        if (scale_direct(src, scaled, policy, &capacity))
+        {
+          int res = convert(scaled, dest, policy);
+          frame_pool::release(scaled.data, capacity);
+          return res;
+        }
+      }
+    }
+
     //step 1: uncompress source, to have raw uncompressed rgb or ycbcr
 
     // Format we need the source in
@@ -772,8 +1166,14 @@ namespace urbi
       = (PivotImage::converters
          [src.imageFormat]
          [pivot_in_format(src.imageFormat, targetformat)]);
+    pivot.min_width = dest.width;
+    pivot.min_height = dest.height;
     if (converter)
+    {
       (pivot.*converter)(src);
+      if (!pivot.data)
+        return 0;
+    }
 
     if (dest.width == 0)
       dest.width = pivot.width;
@@ -783,17 +1183,23 @@ namespace urbi
     //now resize if target size is different
     if (pivot.width != dest.width || pivot.height != dest.height)
     {
-      byte* scaled = (byte*)malloc(dest.width * dest.height * 3);
-      scaleColorImage(pivot.data,
-                      pivot.width, pivot.height,
-                      pivot.width / 2, pivot.height / 2,
-                      scaled, dest.width, dest.height,
-                      (ufloat) dest.width / (ufloat) src.width,
-                      (ufloat) dest.height / (ufloat) src.height);
-      if (pivot.allocated)
-        free(pivot.data);
+      size_t capacity;
+      byte* scaled = static_cast<byte*>(
+        frame_pool::acquire(dest.width * dest.height * 3, capacity));
+      ScaleJob job =
+        {
+          pivot.data, pivot.width, pivot.height, 3,
+          scaled, dest.width, dest.height, policy.filter
+        };
+      bands::run(dest.height, boost::ref(job),
+                 policy.threads, policy.band_rows);
+      pivot.release();
       pivot.data = scaled;
       pivot.allocated = true;
+      pivot.capacity = capacity;
+      pivot.width = dest.width;
+      pivot.height = dest.height;
+      pivot.size = dest.width * dest.height * 3;
     }
     // Then factor YUV<->RGB conversion if necessary
     if ((pivot.imageFormat == IMAGE_RGB && targetformat == IMAGE_YCbCr)
@@ -802,13 +1208,18 @@ namespace urbi
       byte* src = pivot.data;
       if (!pivot.allocated)
       {
-        pivot.allocated = true;
-        pivot.data = (byte*) malloc(pivot.size);
+        pivot.data = 0;
+        pivot.alloc(pivot.size);
       }
-      if (pivot.imageFormat == IMAGE_RGB)
-        convertRGBtoYCbCr(src, pivot.size, pivot.data);
-      else
-        convertYCbCrtoRGB(src, pivot.size, pivot.data);
+      size_t row = dest.width * 3;
+      BufferJob job =
+        {
+          (pivot.imageFormat == IMAGE_RGB
+           ? &convertRGBtoYCbCr : &convertYCbCrtoRGB),
+          src, row, pivot.data, row
+        };
+      bands::run(dest.height, boost::ref(job),
+                 policy.threads, policy.band_rows);
       pivot.imageFormat = targetformat;
     }
     // Then convert to destination format.
@@ -835,9 +1246,17 @@ namespace urbi
       memcpy(dest.data, pivot.data, pivot.size);
       break;
     case IMAGE_GREY8:
+    {
       assert(pivot.imageFormat == IMAGE_RGB);
-      convertRGBtoGrey8_601(pivot.data, pivot.size, (byte*) dest.data);
+      BufferJob job =
+        {
+          &convertRGBtoGrey8_601,
+          pivot.data, dest.width * 3, dest.data, dest.width
+        };
+      bands::run(dest.height, boost::ref(job),
+                 policy.threads, policy.band_rows);
       break;
+    }
     case IMAGE_YCbCr:
       memcpy(dest.data, pivot.data, pivot.size);
       break;
@@ -852,63 +1271,32 @@ namespace urbi
       if (pivot.imageFormat == IMAGE_YCbCr)
         convertYCrCbtoJPEG(pivot.data,
                            dest.width, dest.height,
-                           (byte*) dest.data, dsz, 80);
+                           (byte*) dest.data, dsz, policy.jpeg_quality);
       else
         convertRGBtoJPEG(pivot.data,
                          dest.width, dest.height,
-                         (byte*) dest.data, dsz, 80);
+                         (byte*) dest.data, dsz, policy.jpeg_quality);
       dest.size = dsz;
       break;
     case IMAGE_YUV411_PLANAR:
-    {
-      for (unsigned int i = 0; i < plane; ++i)
-        dest.data[i] = pivot.data[i * 3];
-      for (unsigned int y = 0; y < dest.height; y++)
-        for (unsigned int x = 0; x < dest.width; x += 4)
-        {
-          dest.data[plane + x / 4 + y * dest.width / 4]
-            = pivot.data[(x + y * dest.width) * 3 + 1];
-          dest.data[plane+plane / 4 + x / 4 + y * dest.width / 4]
-            = pivot.data[(x + y * dest.width) * 3 + 2];
-        }
-      break;
-    }
     case IMAGE_YUV420_PLANAR:
-    {
-      for (unsigned int i = 0; i < plane; ++i)
-        dest.data[i] = pivot.data[i * 3];
-      for (unsigned int y = 0; y < dest.height / 2; y++)
-        for (unsigned int x = 0; x < dest.width / 2; x++)
-        {
-          dest.data[plane + x + y * dest.width / 2]
-            = pivot.data[(x * 2 + y * 2 * dest.width) * 3 + 1];
-          dest.data[plane + plane/4 + x + y * dest.width / 2]
-            = pivot.data[(x * 2 + y * 2 * dest.width) * 3 + 2];
-        }
-      break;
-    }
     case IMAGE_NV12:
     {
-      for (unsigned int p = 0; p < plane; ++p)
-        dest.data[p] = pivot.data[p * 3];
-      // crcb interleaved plane
-      for (unsigned int y = 0; y < dest.height; y += 2)
-        for (unsigned int x = 0; x < dest.width; x += 2)
+      PlanarJob job =
         {
-          dest.data[plane + x + y * dest.width / 2]
-            = pivot.data[(x + y * dest.width) * 3 + 1];
-          dest.data[plane + x + y * dest.width / 2 + 1]
-            = pivot.data[(x + y * dest.width) * 3 + 2];
-        }
-      dest.size = plane * 3 / 2;
+          dest.imageFormat, pivot.data, dest.data, dest.width, dest.height
+        };
+      bands::run(dest.height, boost::ref(job),
+                 policy.threads, policy.band_rows);
+      if (dest.imageFormat == IMAGE_NV12)
+        dest.size = plane * 3 / 2;
+      break;
     }
-    break;
     default:
       GD_FERROR("Image conversion to format %s is not implemented",
                 dest.format_string());
     }
-    if (pivot.allocated)
-      free(pivot.data);
+    pivot.release();
     return 1;
   }
 
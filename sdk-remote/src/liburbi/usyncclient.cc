@@ -14,6 +14,7 @@
 #include <libport/cassert>
 #include <libport/compiler.hh>
 #include <libport/debug.hh>
+#include <libport/foreach.hh>
 #include <libport/thread.hh>
 #include <libport/unistd.h>
 
@@ -57,6 +58,83 @@ namespace urbi
     return *this;
   }
 
+  /*---------.
+  | Future.  |
+  `---------*/
+
+  USyncClient::Future::Future(const std::string& tag)
+    : tag_(tag)
+    , message_(0)
+    , ready_(false)
+    , waitingFromPollThread_(false)
+  {}
+
+  USyncClient::Future::~Future()
+  {
+    delete message_;
+  }
+
+  void
+  USyncClient::Future::complete(UMessage* msg)
+  {
+    libport::BlockLock bl(lock_);
+    message_ = msg;
+    ready_ = true;
+    if (waitingFromPollThread_)
+      libport::get_io_service().stop();
+    else
+      sem_++;
+  }
+
+  const UMessage*
+  USyncClient::Future::get(libport::utime_t useconds)
+  {
+    {
+      libport::BlockLock bl(lock_);
+      if (ready_)
+        return message_;
+      waitingFromPollThread_ = libport::isPollThread();
+      // Reset before releasing the lock, as complete may call io.stop().
+      if (waitingFromPollThread_)
+        libport::get_io_service().reset();
+    }
+
+    // The answer is delivered by the polling thread: if we are it,
+    // process the sockets until it arrives.
+    if (!waitingFromPollThread_)
+    {
+      if (!sem_.uget(useconds))
+        GD_FERROR("Timed out waiting for %s", tag_);
+    }
+    else if (useconds)
+      libport::pollFor(useconds);
+    else
+      libport::get_io_service().run();
+
+    libport::BlockLock bl(lock_);
+    waitingFromPollThread_ = false;
+    if (ready_ && !message_)
+      GD_FERROR("Connection closed waiting for %s", tag_);
+    return message_;
+  }
+
+  bool
+  USyncClient::Future::ready() const
+  {
+    libport::BlockLock bl(lock_);
+    return ready_;
+  }
+
+  const std::string&
+  USyncClient::Future::tag() const
+  {
+    return tag_;
+  }
+
+  /*--------------.
+  | USyncClient.  |
+  `--------------*/
+
   UCLIENT_OPTION_IMPL(USyncClient, bool, startCallbackThread);
   UCLIENT_OPTION_IMPL(USyncClient, USyncClient::connect_callback_type,
                       connectCallback);
@@ -201,8 +279,15 @@ namespace urbi
   USyncClient::notifyCallbacks(const UMessage& msg)
   {
     queueLock_.lock();
+    futures_type::iterator future;
     // If waiting for a tag, pass it to the user.
-    if (!syncTag.empty() && syncTag == msg.tag)
+    if (!futures_.empty()
+        && (future = futures_.find(msg.tag)) != futures_.end())
+    {
+      future->second->complete(new UMessage(msg));
+      futures_.erase(future);
+    }
+    else if (!syncTag.empty() && syncTag == msg.tag)
     {
       message_ = new UMessage(msg);
       syncTag.clear();
@@ -297,6 +382,14 @@ namespace urbi
 
     UClient::onClose();
 
+    // No answer will come.
+    queueLock_.lock();
+    futures_type futures;
+    std::swap(futures, futures_);
+    queueLock_.unlock();
+    foreach (futures_type::value_type& f, futures)
+      f.second->complete(0);
+
     stopCallbackThread_ = true;
     callbackSem_++;
     sem_++;
@@ -330,6 +423,59 @@ namespace urbi
                       opt_used.timeout_);
   }
 
+  USyncClient::future_type
+  USyncClient::asyncGet_(const char* format, va_list& arg,
+                         const USyncClient::send_options& options)
+  {
+    const USyncClient::send_options& opt_used = getOptions(options);
+    if (has_tag(format))
+      return future_type();
+    sendBufferLock.lock();
+    std::string tag = make_tag(*this, opt_used);
+    pack("%s", compatibility::evaluate_in_channel_open
+         (tag, kernelMajor()).c_str());
+    rc = vpack(format, arg);
+    if (rc < 0)
+    {
+      sendBufferLock.unlock();
+      return future_type();
+    }
+    pack("%s", compatibility::evaluate_in_channel_close
+         (tag, kernelMajor()).c_str());
+    // Register before sending, the answer may come at any time.
+    future_type res(new Future(opt_used.mtag_ ? opt_used.mtag_ : tag));
+    queueLock_.lock();
+    futures_[res->tag()] = res;
+    queueLock_.unlock();
+    rc = effective_send(sendBuffer);
+    sendBuffer[0] = 0;
+    sendBufferLock.unlock();
+    if (rc < 0)
+    {
+      queueLock_.lock();
+      futures_.erase(res->tag());
+      queueLock_.unlock();
+      return future_type();
+    }
+    return res;
+  }
+
+  USyncClient::future_type
+  USyncClient::asyncGet(const char* format, ...)
+  {
+    va_list arg;
+    va_start(arg, format);
+    future_type res = asyncGet_(format, arg);
+    va_end(arg);
+    return res;
+  }
+
+  USyncClient::future_type
+  USyncClient::asyncGet(const std::string& msg)
+  {
+    return asyncGet("%s", msg.c_str());
+  }
+
   UMessage*
   USyncClient::syncGet(const char* format, ...)
   {
@@ -479,6 +625,74 @@ namespace urbi
     return getValue(syncGetTag(useconds, "%s;", tag, 0, valName), val);
   }
 
+  size_t
+  USyncClient::syncGetValues(const std::vector<std::string>& valNames,
+                             std::vector<UValue>& vals,
+                             libport::utime_t useconds)
+  {
+    vals.clear();
+    vals.resize(valNames.size());
+    std::vector<future_type> futures;
+    futures.reserve(valNames.size());
+    // Send all the requests in a single packet.  Do not use
+    // sendBuffer, which might be too small.
+    std::string requests;
+    foreach (const std::string& name, valNames)
+    {
+      std::string tag = fresh();
+      requests += compatibility::evaluate_in_channel_open(tag, kernelMajor());
+      requests += name;
+      requests += ';';
+      requests += compatibility::evaluate_in_channel_close(tag, kernelMajor());
+      futures << future_type(new Future(tag));
+    }
+    // Register before sending, the answers may come at any time.
+    queueLock_.lock();
+    foreach (const future_type& f, futures)
+      futures_[f->tag()] = f;
+    queueLock_.unlock();
+    sendBufferLock.lock();
+    bool failed = effective_send(requests) < 0;
+    sendBufferLock.unlock();
+    if (failed)
+    {
+      // No answer will come: do not wait for it, even forever.
+      queueLock_.lock();
+      foreach (const future_type& f, futures)
+        futures_.erase(f->tag());
+      queueLock_.unlock();
+      foreach (const future_type& f, futures)
+        f->complete(0);
+      return 0;
+    }
+
+    size_t res = 0;
+    libport::utime_t deadline = libport::utime() + useconds;
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+      libport::utime_t left = 0;
+      if (useconds)
+      {
+        left = deadline - libport::utime();
+        // The time is up, but the answers may be there already.
+        if (left <= 0 && !futures[i]->ready())
+          break;
+      }
+      const UMessage* m = futures[i]->get(std::max(left, libport::utime_t(0)));
+      if (m && m->type == MESSAGE_DATA)
+      {
+        vals[i] = *m->value;
+        ++res;
+      }
+    }
+    // Forget about the answers that did not come in time.
+    queueLock_.lock();
+    foreach (const future_type& f, futures)
+      futures_.erase(f->tag());
+    queueLock_.unlock();
+    return res;
+  }
+
   int
   USyncClient::syncGetDevice(const char* device, ufloat& val,
 			     libport::utime_t useconds)
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/// \file libuvalue/frame-pool.cc
+
+#include <libport/cstdlib>
+#include <map>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <urbi/frame-pool.hh>
+
+namespace urbi
+{
+  namespace frame_pool
+  {
+    namespace
+    {
+      /// The size classes are the multiples of p/8 in (p, 2p], for the
+      /// powers of two p from min: sizes are rounded by at most 12.5%.
+      enum { min = 64 };
+
+      /// The step of the classes around \a n: the classes in (p, 2p]
+      /// if \a upper, otherwise in [p, 2p).
+      inline size_t
+      step(size_t n, bool upper)
+      {
+        size_t p = min;
+        while (upper ? 2 * p < n : 2 * p <= n)
+          p *= 2;
+        return p / 8;
+      }
+
+      /// The smallest class at least \a n.
+      inline size_t
+      ceil_class(size_t n)
+      {
+        if (n <= min)
+          return min;
+        size_t s = step(n, true);
+        return (n + s - 1) / s * s;
+      }
+
+      /// The largest class at most \a n, or 0.
+      inline size_t
+      floor_class(size_t n)
+      {
+        if (n < min)
+          return 0;
+        size_t s = step(n, false);
+        return n / s * s;
+      }
+
+      /// The buffers kept, by class.  Each buffer is at least as large
+      /// as its class.
+      typedef std::map<size_t, std::vector<void*> > buffers_type;
+
+      struct Pool
+      {
+        Pool()
+          : max_bytes(64 << 20)
+        {}
+
+        buffers_type buffers;
+        size_t max_bytes;
+        Stats counters;
+        boost::mutex mutex;
+      };
+
+      static Pool&
+      pool()
+      {
+        // Never destroyed: binaries may be released by the destructors
+        // of other static objects.
+        static Pool* res = new Pool;
+        return *res;
+      }
+    }
+
+    Stats::Stats()
+      : hits(0)
+      , misses(0)
+      , releases(0)
+      , drops(0)
+      , buffers(0)
+      , bytes(0)
+    {}
+
+    void*
+    acquire(size_t size, size_t& capacity)
+    {
+      Pool& p = pool();
+      capacity = ceil_class(size);
+      {
+        boost::mutex::scoped_lock lock(p.mutex);
+        buffers_type::iterator i = p.buffers.find(capacity);
+        if (i != p.buffers.end() && !i->second.empty())
+        {
+          void* res = i->second.back();
+          i->second.pop_back();
+          ++p.counters.hits;
+          --p.counters.buffers;
+          p.counters.bytes -= capacity;
+          return res;
+        }
+        ++p.counters.misses;
+      }
+      return malloc(capacity);
+    }
+
+    void
+    release(void* data, size_t capacity)
+    {
+      if (!data)
+        return;
+      Pool& p = pool();
+      // Buffers from elsewhere are filed under the class below their
+      // size, the ones of the pool under their own.
+      size_t c = floor_class(capacity);
+      {
+        boost::mutex::scoped_lock lock(p.mutex);
+        if (c && p.counters.bytes + c <= p.max_bytes)
+        {
+          p.buffers[c].push_back(data);
+          ++p.counters.releases;
+          ++p.counters.buffers;
+          p.counters.bytes += c;
+          return;
+        }
+        ++p.counters.drops;
+      }
+      free(data);
+    }
+
+    void
+    clear()
+    {
+      Pool& p = pool();
+      buffers_type old;
+      {
+        boost::mutex::scoped_lock lock(p.mutex);
+        std::swap(old, p.buffers);
+        p.counters.buffers = 0;
+        p.counters.bytes = 0;
+      }
+      for (buffers_type::iterator i = old.begin(); i != old.end(); ++i)
+        for (size_t j = 0; j < i->second.size(); ++j)
+          free(i->second[j]);
+    }
+
+    size_t
+    limit()
+    {
+      Pool& p = pool();
+      boost::mutex::scoped_lock lock(p.mutex);
+      return p.max_bytes;
+    }
+
+    void
+    limit(size_t bytes)
+    {
+      Pool& p = pool();
+      {
+        boost::mutex::scoped_lock lock(p.mutex);
+        p.max_bytes = bytes;
+        if (p.counters.bytes <= p.max_bytes)
+          return;
+      }
+      clear();
+    }
+
+    Stats
+    stats()
+    {
+      Pool& p = pool();
+      boost::mutex::scoped_lock lock(p.mutex);
+      return p.counters;
+    }
+
+    void
+    reset_stats()
+    {
+      Pool& p = pool();
+      boost::mutex::scoped_lock lock(p.mutex);
+      p.counters.hits = p.counters.misses = 0;
+      p.counters.releases = p.counters.drops = 0;
+    }
+  }
+}
@@ -24,6 +24,7 @@ libuvalue_libuvalue_la_LIBADD = $(BOOST_THREAD_LIBS)
 dist_libuvalue_libuvalue_la_SOURCES =		\
   liburbi/urbi-root.cc				\
   libuvalue/exit.cc				\
+  libuvalue/frame-pool.cc			\
   libuvalue/package-info.cc			\
   libuvalue/ubinary.cc				\
   libuvalue/uimage.cc				\
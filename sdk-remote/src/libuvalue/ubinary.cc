@@ -29,6 +29,8 @@ namespace urbi
     : type(BINARY_NONE)
     , allocated_(true)
     , temporary_(false)
+    , pooled_(0)
+    , capacity_(0)
   {
     common.data = 0;
     common.size = 0;
@@ -38,6 +40,8 @@ namespace urbi
     : type(BINARY_NONE)
     , allocated_(copy)
     , temporary_(temp)
+    , pooled_(0)
+    , capacity_(0)
   {
     common.data = 0;
     if (copy)
@@ -57,10 +61,12 @@ namespace urbi
     , image(i)
     , allocated_(copy)
     , temporary_(false)
+    , pooled_(0)
+    , capacity_(0)
   {
     if (copy)
     {
-      image.data = static_cast<unsigned char*> (malloc (image.size));
+      allocate_();
       memcpy(image.data, i.data, image.size);
     }
   }
@@ -70,22 +76,37 @@ namespace urbi
     , sound(i)
     , allocated_(copy)
     , temporary_(false)
+    , pooled_(0)
+    , capacity_(0)
   {
     if (copy)
     {
-      sound.data = static_cast<char*> (malloc (sound.size));
+      allocate_();
       memcpy(sound.data, i.data, sound.size);
     }
   }
 
+  void
+  UBinary::allocate_()
+  {
+    common.data = frame_pool::acquire(common.size, capacity_);
+    pooled_ = common.data;
+  }
+
   void
   UBinary::clear()
   {
     if (allocated_)
     {
-      free(common.data);
+      // The user may have replaced the buffer.
+      if (common.data && common.data == pooled_)
+        frame_pool::release(common.data, capacity_);
+      else
+        free(common.data);
       common.data = 0;
       common.size = 0;
+      pooled_ = 0;
+      capacity_ = 0;
     }
   }
 
@@ -107,8 +128,12 @@ namespace urbi
       sound = b.sound;
       message = b.message;
       type = b.type;
+      pooled_ = b.pooled_;
+      capacity_ = b.capacity_;
       UBinary& bb = const_cast<UBinary&>(b);
       bb.common.data = 0;
+      bb.pooled_ = 0;
+      bb.capacity_ = 0;
       bb.type = BINARY_NONE;
       temporary_ = true;
       return *this;
@@ -128,7 +153,7 @@ namespace urbi
       case BINARY_UNKNOWN:
 	break;
     }
-    common.data = malloc(common.size);
+    allocate_();
     memcpy(common.data, b.common.data, b.common.size);
     return *this;
   }
@@ -208,8 +233,19 @@ namespace urbi
     common.size = psize;
     if (copy)
     {
-      common.data = malloc(common.size);
-      memcpy(common.data, binpos->data, common.size);
+      // Adopt the buffer when it is given rather than copying it.
+      size_t capacity = binpos->capacity;
+      common.data = binpos->release();
+      if (common.data)
+      {
+        pooled_ = capacity ? common.data : 0;
+        capacity_ = capacity;
+      }
+      else
+      {
+        allocate_();
+        memcpy(common.data, binpos->data, common.size);
+      }
     }
     else
     {
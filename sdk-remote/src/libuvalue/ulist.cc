@@ -10,6 +10,11 @@
 
 /// \file libuvalue/ulist.cc
 
+#include <algorithm>
+
+#include <boost/type_traits/alignment_of.hpp>
+
+#include <libport/cstdlib>
 #include <libport/debug.hh>
 #include <libport/escape.hh>
 
@@ -22,12 +27,102 @@ GD_CATEGORY(Urbi.UValue);
 namespace urbi
 {
 
+  /*--------.
+  | Block.  |
+  `--------*/
+
+  /// A header, followed by room for \c size UValues, of which the
+  /// first \c used are built.
+  struct UList::Block
+  {
+    Block* next;
+    size_t size;
+    size_t used;
+
+    /// The size of the header, keeping the UValues aligned.
+    static const size_t header =
+      (sizeof(Block) + boost::alignment_of<UValue>::value - 1)
+      / boost::alignment_of<UValue>::value
+      * boost::alignment_of<UValue>::value;
+
+    UValue*
+    values()
+    {
+      return reinterpret_cast<UValue*>(reinterpret_cast<char*>(this)
+                                       + header);
+    }
+
+    const UValue*
+    values() const
+    {
+      return const_cast<Block*>(this)->values();
+    }
+  };
+
+  void*
+  UList::slot_()
+  {
+    if (!blocks_ || blocks_->used == blocks_->size)
+      grow_(1);
+    return blocks_->values() + blocks_->used;
+  }
+
+  void
+  UList::grow_(size_t n)
+  {
+    // Double the size of the blocks, to keep their number
+    // logarithmic in the size of the list.
+    n = std::max(n, blocks_ ? 2 * blocks_->size : 8);
+    Block* b = static_cast<Block*>(malloc(Block::header
+                                          + n * sizeof(UValue)));
+    if (!b)
+      throw std::bad_alloc();
+    b->next = blocks_;
+    b->size = n;
+    b->used = 0;
+    blocks_ = b;
+  }
+
+  void
+  UList::adopt_(UValue* v)
+  {
+    ++blocks_->used;
+    array.push_back(v);
+  }
+
+  bool
+  UList::owns_(const UValue* v) const
+  {
+    for (const Block* b = blocks_; b; b = b->next)
+      if (b->values() <= v && v < b->values() + b->used)
+        return true;
+    return false;
+  }
+
+  void
+  UList::reserve(size_t n)
+  {
+    array.reserve(n);
+    if (n <= array.size())
+      return;
+    n -= array.size();
+    if (!blocks_ || blocks_->size - blocks_->used < n)
+      grow_(n);
+  }
+
+
+  /*--------.
+  | UList.  |
+  `--------*/
+
   UList::UList()
     : offset(0)
+    , blocks_(0)
   {}
 
   UList::UList(const UList& b)
     : offset(0)
+    , blocks_(0)
   {
     *this = b;
   }
@@ -37,8 +132,9 @@ namespace urbi
     if (this == &b)
       return *this;
     clear();
+    reserve(b.size());
     foreach (UValue* v, b.array)
-      array.push_back(new UValue(*v));
+      push_back(*v);
     offset = b.offset;
     return *this;
   }
@@ -60,8 +156,16 @@ namespace urbi
   {
     offset = 0;
     foreach (UValue *v, array)
-      delete v;
+      if (!owns_(v))
+        delete v;
     array.clear();
+    while (Block* b = blocks_)
+    {
+      blocks_ = b->next;
+      for (size_t i = 0; i < b->used; ++i)
+        b->values()[i].~UValue();
+      free(b);
+    }
   }
 
   std::ostream&
@@ -11,6 +11,10 @@
 /// \file libuvalue/uvalue-common.cc
 #include <boost/algorithm/string/erase.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/cstdint.hpp>
+
+#include <cerrno>
+#include <cfloat>
 
 #include <libport/cassert>
 #include <libport/compiler.hh>
@@ -123,6 +127,150 @@ namespace urbi
     {
       return !strncmp(prefix, string, strlen(prefix));
     }
+
+    static
+    bool
+    is_digit(char c)
+    {
+      return '0' <= c && c <= '9';
+    }
+
+    /// The powers of ten that are exactly representable as doubles.
+    static const double powers_of_ten[] =
+    {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    /// Parse the number at \a s, as strtod would in the C locale.
+    ///
+    /// Numbers with at most 19 significant digits whose value fits
+    /// exactly in the mantissa of a double, and with an exponent in
+    /// [-22, 22], are converted by a single correctly rounded
+    /// multiplication or division, hence exactly (Clinger's fast
+    /// path).  This covers what the kernel prints for usual values.
+    /// The others, or those with hexadecimal or non finite notations,
+    /// are left to strtod.
+    ///
+    /// \return the end of the number, or \a s if there is none.  As
+    /// with strtod, errno is set on overflow.
+    static
+    const char*
+    parse_double(const char* s, double& res)
+    {
+      // Excess precision (x87) would round twice.
+#if defined FLT_EVAL_METHOD && FLT_EVAL_METHOD == 0
+      const char* p = s;
+      bool negative = *p == '-';
+      if (*p == '-' || *p == '+')
+        ++p;
+      boost::uint64_t mantissa = 0;
+      int digits = 0;
+      int exponent = 0;
+      bool exact = true;
+      const char* first = p;
+      for (; is_digit(*p); ++p)
+        if (digits < 19)
+        {
+          mantissa = mantissa * 10 + (*p - '0');
+          digits += !!mantissa;
+        }
+        else
+          exact = false;
+      bool number = p != first;
+      if (*p == '.')
+      {
+        first = ++p;
+        for (; is_digit(*p); ++p)
+          if (digits < 19)
+          {
+            mantissa = mantissa * 10 + (*p - '0');
+            digits += !!mantissa;
+            --exponent;
+          }
+          else
+            exact = false;
+        number = number || p != first;
+      }
+      if (number && exact && *p != 'x' && *p != 'X')
+      {
+        if (*p == 'e' || *p == 'E')
+        {
+          const char* e = p + 1;
+          bool eneg = *e == '-';
+          if (*e == '-' || *e == '+')
+            ++e;
+          if (is_digit(*e))
+          {
+            int value = 0;
+            for (; is_digit(*e); ++e)
+              if (value < 10000)
+                value = value * 10 + (*e - '0');
+            exponent += eneg ? -value : value;
+            p = e;
+          }
+        }
+        if (!mantissa)
+        {
+          res = negative ? -0.0 : 0.0;
+          return p;
+        }
+        if (mantissa <= (boost::uint64_t(1) << 53)
+            && -22 <= exponent && exponent <= 22)
+        {
+          double d = double(mantissa);
+          d = exponent < 0
+            ? d / powers_of_ten[-exponent]
+            : d * powers_of_ten[exponent];
+          res = negative ? -d : d;
+          return p;
+        }
+      }
+#endif
+      char* end;
+      res = libport::strtod_c(s, &end);
+      return end;
+    }
+
+    /// Move the contents of \a from into \a to, which is void.
+    static
+    void
+    steal(UValue& to, UValue& from)
+    {
+      to.type = from.type;
+      to.val = from.val;
+      to.storage = from.storage;
+      from.type = DATA_VOID;
+    }
+
+    /// Parse a number at \a message + \a pos into \a v.
+    /// \return the position after it, or -\a pos if there is none.
+    static
+    int
+    parse_number(UValue& v, const char* message, int pos)
+    {
+      errno = 0;
+      double d;
+      const char* end = parse_double(message + pos, d);
+      // Did we find a number?  Make sure we don't overflow.
+      if (end != message + pos)
+      {
+        if (errno)
+        {
+          GD_FWARN("syntax error (ignored): %s: \"%s\"",
+                   libport::strerror(errno), libport::escape(message + pos));
+          d = 0;
+        }
+        v.type = DATA_DOUBLE;
+        v.val = d;
+        return end - message;
+      }
+
+      // Anything else is an error, but be resilient and ignore it.
+      GD_FWARN("parse error (ignored): \"%s\"", libport::escape(message + pos));
+      return -pos;
+    }
   }
 
 // Works on message[pos].
@@ -159,15 +307,29 @@ namespace urbi
       type = DATA_STRING;
       //get terminating '"'
       int p = pos + 1;
+      bool escaped = false;
       while (message[p] && message[p] != '"')
-        p += 1 + (message[p] == '\\');
+        if (message[p++] == '\\')
+        {
+          escaped = true;
+          if (message[p])
+            ++p;
+        }
       CHECK_NEOF();
 
-      stringValue = new std::string(
-        libport::unescape(std::string(message + pos + 1, p - pos - 1)));
+      // Most strings have nothing to unescape.
+      stringValue = escaped
+        ? new std::string(
+          libport::unescape(std::string(message + pos + 1, p - pos - 1)))
+        : new std::string(message + pos + 1, p - pos - 1);
       return p + 1;
     }
 
+    // Numbers first, they are the most frequent values.
+    if (is_digit(message[pos])
+        || message[pos] == '-' || message[pos] == '.')
+      return parse_number(*this, message, pos);
+
     if (message[pos] == '[')
     {
       // List or Dictionary message.
@@ -196,44 +358,50 @@ namespace urbi
           }
 	  break;
         }
-        UValue* v = new UValue();
-	pos = v->parse(message, pos, bins, binpos);
-	if (pos < 0)
+        // Once known to be a list, parse the elements in place.
+        if (type == DATA_LIST)
         {
-          delete v;
-	  return pos;
+          pos = list->append().parse(message, pos, bins, binpos);
+          if (pos < 0)
+            return pos;
         }
-        SKIP_SPACES();
-        // Here is a dictionary key.
-        if ((type == DATA_DICTIONARY || type == DATA_VOID)
-            && !::strncmp(message + pos, "=>", 2) && v->type == DATA_STRING)
+        else
         {
-          if (type == DATA_VOID)
+          UValue v;
+          pos = v.parse(message, pos, bins, binpos);
+          if (pos < 0)
+            return pos;
+          SKIP_SPACES();
+          // Here is a dictionary key.
+          if (!::strncmp(message + pos, "=>", 2) && v.type == DATA_STRING)
           {
-            type = DATA_DICTIONARY;
-            dictionary = new UDictionary();
+            if (type == DATA_VOID)
+            {
+              type = DATA_DICTIONARY;
+              dictionary = new UDictionary();
+            }
+
+            pos += 2;
+            SKIP_SPACES();
+            // Handle value associated with given key.
+            UValue& val = (*dictionary)[*v.stringValue];
+            val.clear();
+            pos = val.parse(message, pos, bins, binpos);
+            if (pos < 0)
+              return pos;
           }
-
-          pos += 2;
-          SKIP_SPACES();
-          // Handle value associated with given key.
-          std::string key = *(v->stringValue);
-          (*dictionary)[key] = UValue();
-          pos = (*dictionary)[key].parse(message, pos, bins, binpos);
-          if (pos < 0)
+          else if (type == DATA_DICTIONARY)
           {
-            delete v;
-            return pos;
+            GD_FERROR("parse error: expected a key"
+                      " in `%s' at %s", message, pos);
+            return -pos;
           }
-        }
-        else
-        {
-          if (type == DATA_VOID)
+          else
           {
             type = DATA_LIST;
             list = new UList();
+            steal(list->append(), v);
           }
-          list->array.push_back(v);
         }
 	SKIP_SPACES();
 	// Expect "," or "]".
@@ -288,27 +456,7 @@ namespace urbi
     }
 
     // Last attempt: it should be a double.
-    {
-      char *end;
-      double d = libport::strtod_c(message+pos, &end);
-      // Did we find a number?  Make sure we don't overflow.
-      if (end != message + pos)
-      {
-        if (errno)
-        {
-          GD_FWARN("syntax error (ignored): %s: \"%s\"",
-                   libport::strerror(errno), libport::escape(message + pos));
-          d = 0;
-        }
-        type = DATA_DOUBLE;
-        val = d;
-        return end - message;
-      }
-    }
-
-    // Anything else is an error, but be resilient and ignore it.
-    GD_FWARN("parse error (ignored): \"%s\"", libport::escape(message + pos));
-    return -pos;
+    return parse_number(*this, message, pos);
   }
 
   std::ostream&
@@ -568,14 +716,16 @@ namespace urbi
           for (unsigned int i = 0; i<mins; ++i)
             list->array[i]->set(*v.list->array[i]);
           // Destroy extra ones
-          for(unsigned int k= 0; k<list->array.size() - mins; ++k)
+          while (mins < list->array.size())
           {
-            delete list->array.back();
+            UValue* e = list->array.back();
             list->array.pop_back();
+            if (!list->owns_(e))
+              delete e;
           }
           // Or push new ones
           for (unsigned int j = mins; j< v.list->array.size(); ++j)
-            list->array.push_back(new UValue(v.list->array[j]));
+            list->push_back(*v.list->array[j]);
         }
         else
           list = new UList(*v.list);
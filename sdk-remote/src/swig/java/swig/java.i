@@ -849,6 +849,9 @@ namespace urbi
 namespace urbi
 {
   %ignore USyncClient::USyncClient;
+  %ignore USyncClient::Future;
+  %ignore USyncClient::asyncGet;
+  %ignore USyncClient::asyncGet_;
   %ignore USyncClient::getOptions;
   %ignore USyncClient::listen;
   %ignore USyncClient::setDefaultOptions;
@@ -857,6 +860,7 @@ namespace urbi
   %ignore USyncClient::syncGetImage;
   %ignore USyncClient::syncGetNormalizedDevice;
   %ignore USyncClient::syncGetResult;
+  %ignore USyncClient::syncGetValues;
   %ignore USyncClient::syncSend;
 }
 
@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+#include <cstdlib>
+
+#include <libport/debug.hh>
+
+#include <bin/unit.hh>
+
+GD_INIT();
+
+int
+main()
+{
+  srand(42);
+  test();
+  return 0;
+}
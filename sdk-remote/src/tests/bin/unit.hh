@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+#ifndef SDK_REMOTE_TESTS_UNIT_HH
+# define SDK_REMOTE_TESTS_UNIT_HH
+
+# include <cstdlib>
+# include <vector>
+
+# include <libport/cassert>
+# include <libport/debug.hh>
+
+/* Unit test suite
+
+Checks of the SDK that need no server: unlike the liburbi test suite,
+no client is connected.
+
+Test file layout
+- #includes "unit.hh"
+- helpers in an anonymous namespace
+- BEGIN_TEST
+- the checks, failures abort (assert, assert_eq...)
+- END_TEST
+
+The random numbers are seeded by main, so that failures are
+reproducible.
+*/
+
+/// Register the message category for each file including this header.
+GD_CATEGORY(Test);
+
+#define BEGIN_TEST                              \
+  void                                          \
+  test()                                        \
+  {
+
+#define END_TEST                                \
+  }
+
+void test();
+
+namespace unit
+{
+  typedef std::vector<unsigned char> buffer;
+
+  /// A random number in [0, n).
+  inline
+  size_t
+  rnd(size_t n)
+  {
+    return rand() % n;
+  }
+
+  /// \a size random bytes.
+  inline
+  buffer
+  random_buffer(size_t size)
+  {
+    buffer res(size);
+    for (size_t i = 0; i < size; ++i)
+      res[i] = rnd(256);
+    return res;
+  }
+}
+
+#endif // SDK_REMOTE_TESTS_UNIT_HH
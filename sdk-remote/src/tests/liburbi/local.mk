@@ -16,6 +16,7 @@
 LIBURBI_TESTS =					\
   liburbi/0-empty.cc				\
   liburbi/ping.cc				\
+  liburbi/pipeline.cc				\
   liburbi/removecallbacks.cc			\
   liburbi/syncvalues.cc				\
   liburbi/values.cc				\
@@ -55,6 +56,7 @@ AM_LDFLAGS +=					\
 
 liburbi_0_empty_SOURCES         = bin/tests.hh bin/tests.cc liburbi/0-empty.cc
 liburbi_ping_SOURCES            = bin/tests.hh bin/tests.cc liburbi/ping.cc
+liburbi_pipeline_SOURCES        = bin/tests.hh bin/tests.cc liburbi/pipeline.cc
 liburbi_removecallbacks_SOURCES = bin/tests.hh bin/tests.cc liburbi/removecallbacks.cc
 liburbi_syncvalues_SOURCES      = bin/tests.hh bin/tests.cc liburbi/syncvalues.cc
 liburbi_values_SOURCES          = bin/tests.hh bin/tests.cc liburbi/values.cc
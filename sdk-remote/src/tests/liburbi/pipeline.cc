@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+// Check the pipelined requests of USyncClient: answered out of
+// order, batched, or many pending at once.  urbi-pipeline-bench
+// measures their latency and throughput.
+
+#include <libport/format.hh>
+
+#include <urbi/umessage.hh>
+#include <bin/tests.hh>
+
+static const size_t count = 64;
+
+BEGIN_TEST
+
+syncClient.setErrorCallback(callback(&dump));
+
+SSEND("var pipelined = [];");
+SSEND(libport::format("for (var i: %s) pipelined << i;", count).c_str());
+
+std::vector<std::string> names;
+for (size_t i = 0; i < count; ++i)
+  names.push_back(libport::format("pipelined[%s]", i));
+
+// Several pending requests, answered out of order.
+{
+  urbi::USyncClient::future_type slow =
+    syncClient.asyncGet("sleep(200ms) | \"slow\";");
+  urbi::USyncClient::future_type fast = syncClient.asyncGet("\"fast\";");
+  assert_eq(*fast->get()->value->stringValue, "fast");
+  aver(!slow->ready());
+  assert_eq(*slow->get()->value->stringValue, "slow");
+  // The answer is kept.
+  aver(slow->ready() && slow->get());
+}
+
+// Batched requests.
+{
+  std::vector<urbi::UValue> vals;
+  assert_eq(syncClient.syncGetValues(names, vals), count);
+  for (size_t i = 0; i < count; ++i)
+    assert_eq(int(vals[i]), int(i));
+}
+
+// Many pending requests, answered in order.
+{
+  std::vector<urbi::USyncClient::future_type> fs;
+  for (size_t i = 0; i < count; ++i)
+    fs.push_back(syncClient.asyncGet("%s;", names[i].c_str()));
+  for (size_t i = 0; i < count; ++i)
+    assert_eq(int(*fs[i]->get()->value), int(i));
+}
+
+END_TEST
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+// Check the size classes of the frame pool, and that a stream of
+// images received, converted to a smaller size and destroyed, no
+// longer allocates once the first frame is done.
+
+#include <cstdlib>
+#include <string>
+
+#include <libport/cassert>
+#include <libport/cstring>
+#include <libport/format.hh>
+
+#include <urbi/frame-pool.hh>
+#include <urbi/ubinary.hh>
+#include <urbi/uconversion.hh>
+#include <bin/unit.hh>
+
+namespace
+{
+  namespace pool = urbi::frame_pool;
+
+  static void
+  log(const char* what)
+  {
+    pool::Stats s = pool::stats();
+    GD_FINFO("%s: %s hits, %s misses, %s releases, %s drops, "
+             "%s buffers of %s bytes",
+             what, s.hits, s.misses, s.releases, s.drops,
+             s.buffers, s.bytes);
+  }
+
+  /// Receive a \a w x \a h RGB image as the client does, and convert
+  /// it into \a out, at half size, in grey.
+  static void
+  frame(size_t w, size_t h, urbi::UImage& out)
+  {
+    size_t size = w * h * 3;
+    size_t capacity;
+    void* data = pool::acquire(size, capacity);
+    memset(data, 42, size);
+    urbi::binaries_type bins;
+    bins.push_back(urbi::BinaryData(data, size, true, capacity));
+    urbi::binaries_type::const_iterator i = bins.begin();
+    std::string header = libport::format("%s rgb %s %s;", size, w, h);
+
+    urbi::UBinary bin;
+    assert_lt(0, bin.parse(header.c_str(), 0, bins, i));
+    assert_eq(static_cast<void*>(bin.image.data), data);
+    out.imageFormat = urbi::IMAGE_GREY8;
+    out.width = w / 2;
+    out.height = h / 2;
+    assert_eq(urbi::convert(bin.image, out), 1);
+    assert_eq(out.data[0], 42);
+  }
+}
+
+BEGIN_TEST
+
+pool::clear();
+pool::reset_stats();
+
+// Sizes are rounded up by at most 1/8, and buffers are reused.
+{
+  size_t capacity;
+  void* p = pool::acquire(1000, capacity);
+  assert_lt(999u, capacity);
+  assert_lt(capacity, 1126u);
+  pool::release(p, capacity);
+  size_t again;
+  assert_eq(pool::acquire(1000, again), p);
+  assert_eq(again, capacity);
+  assert_eq(pool::stats().hits, 1u);
+  assert_eq(pool::stats().misses, 1u);
+  free(p);
+}
+
+// Buffers from malloc are filed below their size.
+{
+  void* p = malloc(1000);
+  pool::release(p, 1000);
+  size_t capacity;
+  void* q = pool::acquire(1000, capacity);
+  assert(q != p);
+  free(q);
+  assert_eq(pool::acquire(900, capacity), p);
+  assert_lt(capacity, 1001u);
+  free(p);
+}
+
+// A full pool frees the buffers.
+{
+  size_t limit = pool::limit();
+  pool::limit(0);
+  size_t capacity;
+  pool::release(pool::acquire(100, capacity), capacity);
+  assert_eq(pool::stats().drops, 1u);
+  assert_eq(pool::stats().buffers, 0u);
+  pool::limit(limit);
+}
+
+// A 30fps stream, after its first frame.
+{
+  pool::reset_stats();
+  urbi::UImage out;
+  out.data = 0;
+  frame(640, 480, out);
+  log("first frame");
+  size_t misses = pool::stats().misses;
+  for (size_t i = 0; i < 30; ++i)
+    frame(640, 480, out);
+  log("30 more frames");
+  assert_eq(pool::stats().misses, misses);
+  assert_lt(30u, pool::stats().hits);
+  free(out.data);
+}
+
+pool::clear();
+assert_eq(pool::stats().buffers, 0u);
+assert_eq(pool::stats().bytes, 0u);
+
+END_TEST
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+// Check the vectorized image kernels against their scalar versions,
+// on random images whose width is not a multiple of the vector size,
+// converted at once or in bands, yuv420_to_ycbcr, which is scalar,
+// against the pivot image, and urbi::convert against the kernels it
+// uses, on one thread and on several.  urbi-convert-bench measures
+// their speed.
+
+#include <cstdlib>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include <libport/cassert>
+
+#include <urbi/uconversion.hh>
+#include <urbi/uimage.hh>
+#include <liburbi/bands.hh>
+#include <liburbi/image-kernels.hh>
+#include <bin/unit.hh>
+
+namespace
+{
+  using unit::buffer;
+  using unit::random_buffer;
+  using unit::rnd;
+  namespace k = urbi::image_kernels;
+
+  /// Run \a k1 on \a src in bands of two rows, and \a k2 at once,
+  /// and check they agree.
+  static void
+  check(const char* name, k::kernel_type k1, k::kernel_type k2,
+        const buffer& src, size_t w, size_t h, size_t dest_size)
+  {
+    buffer d1(dest_size);
+    buffer d2(dest_size);
+    for (size_t y = 0; y < h; y += 2)
+      k1(&src[0], w, h, y, y + 2, &d1[0]);
+    k2(&src[0], w, h, 0, h, &d2[0]);
+    if (d1 != d2)
+      GD_FERROR("%s: %sx%s: differs from the scalar version", name, w, h);
+    assert(d1 == d2);
+  }
+
+  /// Convert \a in to \a format with \a policy.
+  static buffer
+  convert(const urbi::UImage& in, urbi::UImageFormat format,
+          size_t width, size_t height,
+          const urbi::ConversionPolicy& policy)
+  {
+    urbi::UImage out;
+    out.imageFormat = format;
+    out.width = width;
+    out.height = height;
+    assert_eq(urbi::convert(in, out, policy), 1);
+    buffer res(out.data, out.data + out.size);
+    free(out.data);
+    return res;
+  }
+
+  /// Check yuv420_to_ycbcr against the conversion through the pivot
+  /// image, which urbi::convert uses when \a h is odd.
+  static void
+  check_pivot(const buffer& src, size_t w, size_t h)
+  {
+    urbi::UImage in;
+    in.data = const_cast<unsigned char*>(&src[0]);
+    in.size = w * h * 3 / 2;
+    in.width = w;
+    in.height = h;
+    in.imageFormat = urbi::IMAGE_YUV420_PLANAR;
+    buffer expected = convert(in, urbi::IMAGE_YCbCr, w, h,
+                              urbi::ConversionPolicy());
+    buffer d(w * h * 3);
+    k::yuv420_to_ycbcr(&src[0], w, h, 0, h, &d[0]);
+    if (d != expected)
+      GD_FERROR("yuv420_to_ycbcr: %sx%s: differs from the pivot image",
+                w, h);
+    assert(d == expected);
+  }
+
+  static void
+  count(std::vector<int>* rows, size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+      ++(*rows)[i];
+  }
+}
+
+BEGIN_TEST
+
+GD_FINFO("image kernels: %s", k::flavor());
+
+for (size_t i = 0; i < 200; ++i)
+{
+  size_t w = 2 * (1 + rnd(100));
+  size_t h = 2 * (1 + rnd(20));
+  buffer src = random_buffer(w * h * 3);
+  check("nv12_to_grey8", k::nv12_to_grey8, k::nv12_to_grey8_scalar,
+        src, w, h, w * h);
+  check("nv12_to_rgb", k::nv12_to_rgb, k::nv12_to_rgb_scalar,
+        src, w, h, w * h * 3);
+  check("rgb_to_grey8", k::rgb_to_grey8, k::rgb_to_grey8_scalar,
+        src, w, h, w * h);
+  check("yuv422_to_rgb", k::yuv422_to_rgb, k::yuv422_to_rgb_scalar,
+        src, w, h, w * h * 3);
+  check_pivot(src, w, h - 1);
+}
+
+// urbi::convert uses the kernels when the size does not change.
+{
+  size_t w = 64;
+  size_t h = 48;
+  buffer src = random_buffer(w * h * 3 / 2);
+  urbi::UImage in;
+  in.data = &src[0];
+  in.size = src.size();
+  in.width = w;
+  in.height = h;
+  in.imageFormat = urbi::IMAGE_NV12;
+  urbi::UImage out;
+  out.imageFormat = urbi::IMAGE_RGB;
+  assert_eq(urbi::convert(in, out), 1);
+  assert_eq(out.size, w * h * 3);
+  buffer expected(w * h * 3);
+  k::nv12_to_rgb_scalar(&src[0], w, h, 0, h, &expected[0]);
+  assert(buffer(out.data, out.data + out.size) == expected);
+  free(out.data);
+}
+
+// Several threads give the same results as one, with and without
+// scaling.
+{
+  size_t w = 320;
+  size_t h = 240;
+  buffer src = random_buffer(w * h * 3);
+  urbi::UImage in;
+  in.data = &src[0];
+  in.size = src.size();
+  in.width = w;
+  in.height = h;
+  in.imageFormat = urbi::IMAGE_RGB;
+  urbi::UImageFormat formats[] =
+    {
+      urbi::IMAGE_GREY8, urbi::IMAGE_NV12, urbi::IMAGE_YCbCr,
+      urbi::IMAGE_YUV411_PLANAR, urbi::IMAGE_YUV420_PLANAR,
+    };
+  for (size_t i = 0; i < sizeof formats / sizeof *formats; ++i)
+    for (size_t scale = 0; scale < 2; ++scale)
+    {
+      size_t dw = scale ? 200 : w;
+      size_t dh = scale ? 150 : h;
+      buffer expected = convert(in, formats[i], dw, dh,
+                                urbi::ConversionPolicy());
+      for (size_t threads = 2; threads <= 4; ++threads)
+        assert(convert(in, formats[i], dw, dh,
+                       urbi::ConversionPolicy(threads, 2)) == expected);
+    }
+}
+
+// Every row is processed once, whatever the number of threads.
+for (size_t threads = 1; threads <= 8; ++threads)
+{
+  std::vector<int> rows(101);
+  urbi::bands::run(rows.size(), boost::bind(&count, &rows, _1, _2),
+                   threads, 1);
+  assert(std::vector<int>(rows.size(), 1) == rows);
+}
+
+END_TEST
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+// Check the image scaling against its scalar version on random
+// planes, and a few properties of the filters: the identity, constant
+// planes, and halving with SCALE_AREA.  Check the JPEG images decoded
+// at reduced size.
+
+#include <cstdlib>
+#include <vector>
+
+#include <libport/cassert>
+
+#include <urbi/uconversion.hh>
+#include <urbi/uimage.hh>
+#include <liburbi/image-scaling.hh>
+#include <bin/unit.hh>
+
+namespace
+{
+  using urbi::byte;
+  using unit::buffer;
+  using unit::random_buffer;
+  using unit::rnd;
+  namespace s = urbi::image_scaling;
+
+  static buffer
+  scale(const buffer& src, size_t sw, size_t sh, size_t channels,
+        size_t dw, size_t dh, urbi::UScaleFilter filter)
+  {
+    buffer res(dw * dh * channels);
+    s::scale(&src[0], sw, sh, channels, &res[0], dw, dh, filter, 0, dh);
+    return res;
+  }
+
+  /// Convert \a in to a \a w x \a h image in \a format.
+  static urbi::UImage
+  convert(const urbi::UImage& in, urbi::UImageFormat format,
+          size_t w = 0, size_t h = 0,
+          const urbi::ConversionPolicy& policy = urbi::ConversionPolicy())
+  {
+    urbi::UImage res;
+    res.imageFormat = format;
+    res.width = w;
+    res.height = h;
+    assert_eq(urbi::convert(in, res, policy), 1);
+    return res;
+  }
+}
+
+BEGIN_TEST
+
+GD_FINFO("image scaling: %s", s::flavor());
+
+urbi::UScaleFilter filters[] =
+  { urbi::SCALE_AUTO, urbi::SCALE_BILINEAR, urbi::SCALE_AREA };
+
+for (size_t i = 0; i < 500; ++i)
+{
+  size_t sw = 1 + rnd(90);
+  size_t sh = 1 + rnd(30);
+  size_t dw = 1 + rnd(90);
+  size_t dh = 1 + rnd(30);
+  size_t channels = 1 + rnd(3);
+  urbi::UScaleFilter filter = filters[rnd(3)];
+  buffer src = random_buffer(sw * sh * channels);
+
+  // Row by row, without SIMD.
+  buffer expected(dw * dh * channels);
+  for (size_t y = 0; y < dh; ++y)
+    s::scale_scalar(&src[0], sw, sh, channels, &expected[0], dw, dh,
+                    filter, y, y + 1);
+  if (scale(src, sw, sh, channels, dw, dh, filter) != expected)
+    GD_FERROR("%sx%s -> %sx%s (%s): differs from the scalar version",
+              sw, sh, dw, dh, filter);
+  assert(scale(src, sw, sh, channels, dw, dh, filter) == expected);
+
+  assert(scale(src, sw, sh, channels, sw, sh, filter) == src);
+
+  buffer grey(sw * sh * channels, 77);
+  assert(scale(grey, sw, sh, channels, dw, dh, filter)
+         == buffer(dw * dh * channels, 77));
+}
+
+// Halving averages the 2x2 blocks.
+{
+  size_t w = 64;
+  size_t h = 32;
+  buffer src = random_buffer(w * h);
+  buffer dest = scale(src, w, h, 1, w / 2, h / 2, urbi::SCALE_AREA);
+  for (size_t y = 0; y < h / 2; ++y)
+    for (size_t x = 0; x < w / 2; ++x)
+    {
+      const byte* p = &src[2 * y * w + 2 * x];
+      assert_eq(dest[y * w / 2 + x], (p[0] + p[1] + p[w] + p[w + 1] + 2) / 4);
+    }
+}
+
+// urbi::convert scales the planar formats without pivot, on one
+// thread and on several alike.
+{
+  size_t w = 320;
+  size_t h = 240;
+  buffer src = random_buffer(w * h * 3 / 2);
+  urbi::UImage in;
+  in.data = &src[0];
+  in.size = src.size();
+  in.width = w;
+  in.height = h;
+  in.imageFormat = urbi::IMAGE_NV12;
+  buffer res[2];
+  for (size_t i = 0; i < 2; ++i)
+  {
+    urbi::UImage out;
+    out.imageFormat = urbi::IMAGE_NV12;
+    out.width = w / 2;
+    out.height = h / 2;
+    assert_eq(urbi::convert(in, out, urbi::ConversionPolicy(1 + 3 * i, 2)),
+              1);
+    assert_eq(out.size, w * h * 3 / 8);
+    res[i] = buffer(out.data, out.data + out.size);
+    free(out.data);
+  }
+  assert(res[0] == res[1]);
+  buffer y(src.begin(), src.begin() + w * h);
+  assert(buffer(res[0].begin(), res[0].begin() + w * h / 4)
+         == scale(y, w, h, 1, w / 2, h / 2, urbi::SCALE_AREA));
+}
+
+// JPEG images are decoded at the smallest scale at least as large as
+// the destination, which is then scaled normally.
+{
+  size_t w = 640;
+  size_t h = 480;
+  buffer src(w * h * 3);
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = i % (w * 3) / 8 + i / (w * 3) / 4;
+  urbi::UImage rgb;
+  rgb.data = &src[0];
+  rgb.size = src.size();
+  rgb.width = w;
+  rgb.height = h;
+  rgb.imageFormat = urbi::IMAGE_RGB;
+
+  urbi::ConversionPolicy low;
+  low.jpeg_quality = 20;
+  urbi::UImage small = convert(rgb, urbi::IMAGE_JPEG, 0, 0, low);
+  urbi::UImage jpeg = convert(rgb, urbi::IMAGE_JPEG);
+  assert_lt(small.size, jpeg.size);
+  free(small.data);
+
+  urbi::UImage full = convert(jpeg, urbi::IMAGE_RGB);
+  assert_eq(full.width, w);
+  assert_eq(full.height, h);
+  urbi::UImage expected = convert(full, urbi::IMAGE_RGB, 150, 100);
+  urbi::UImage scaled = convert(jpeg, urbi::IMAGE_RGB, 150, 100);
+  assert_eq(scaled.size, expected.size);
+  size_t error = 0;
+  for (size_t i = 0; i < scaled.size; ++i)
+    error += abs(scaled.data[i] - expected.data[i]);
+  GD_FINFO("JPEG decoded at 1/4: mean error: %s",
+           double(error) / scaled.size);
+  assert_lt(error, scaled.size);
+  free(scaled.data);
+  free(expected.data);
+
+  // A broken image fails, without harming the next ones.
+  buffer garbage = random_buffer(1000);
+  urbi::UImage broken;
+  broken.data = &garbage[0];
+  broken.size = garbage.size();
+  broken.imageFormat = urbi::IMAGE_JPEG;
+  urbi::UImage out;
+  out.imageFormat = urbi::IMAGE_RGB;
+  assert_eq(urbi::convert(broken, out), 0);
+  free(out.data);
+  urbi::UImage again = convert(jpeg, urbi::IMAGE_RGB);
+  assert(buffer(again.data, again.data + again.size)
+         == buffer(full.data, full.data + full.size));
+  free(again.data);
+  free(full.data);
+  free(jpeg.data);
+}
+
+END_TEST
@@ -0,0 +1,40 @@
+## Copyright (C) 2012, Gostai S.A.S.
+##
+## This software is provided "as is" without warranty of any kind,
+## either expressed or implied, including but not limited to the
+## implied warranties of fitness for a particular purpose.
+##
+## See the LICENSE file for more information.
+
+## ----------------- ##
+## Unit test suite.  ##
+## ----------------- ##
+
+# The checks of the SDK that need no server, see bin/unit.hh.
+UNIT_TESTS =					\
+  unit/frame-pool.cc				\
+  unit/image-kernels.cc				\
+  unit/image-scaling.cc				\
+  unit/scanner.cc				\
+  unit/ulist-alloc.cc				\
+  unit/uvalue-parse.cc
+
+TESTS += $(UNIT_TESTS)
+
+EXTRA_PROGRAMS += $(UNIT_TESTS:.cc=)
+CLEANFILES += $(UNIT_TESTS:.cc=)
+
+# The other flags are those of liburbi/local.mk.
+# Find liburbi/scanner.hh, liburbi/image-*.hh and liburbi/bands.hh.
+AM_CPPFLAGS += -I$(sdk_remote_srcdir)/src
+
+unit_frame_pool_SOURCES    = bin/unit.hh bin/unit.cc unit/frame-pool.cc
+unit_image_kernels_SOURCES = bin/unit.hh bin/unit.cc unit/image-kernels.cc
+unit_image_scaling_SOURCES = bin/unit.hh bin/unit.cc unit/image-scaling.cc
+unit_scanner_SOURCES       = bin/unit.hh bin/unit.cc unit/scanner.cc
+unit_ulist_alloc_SOURCES   = bin/unit.hh bin/unit.cc unit/ulist-alloc.cc
+unit_uvalue_parse_SOURCES  = bin/unit.hh bin/unit.cc unit/uvalue-parse.cc
+
+# Run them directly, no server is needed.
+$(UNIT_TESTS:.cc=.log): %.log: %$(EXEEXT) ../libraries.stamp
+	@$(am__check_pre) ./$*$(EXEEXT) $(am__check_post)
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+// Fuzz the parser of the messages of the server: random streams of
+// messages, received in random chunks, must give the same UMessages
+// as the character-by-character parser it replaced.  Check the
+// vectorized scanner and the header parser against their reference
+// versions.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+#include <libport/cassert>
+#include <libport/cstring>
+#include <libport/foreach.hh>
+#include <libport/format.hh>
+
+#include <urbi/uabstractclient.hh>
+#include <urbi/umessage.hh>
+#include <liburbi/scanner.hh>
+#include <bin/unit.hh>
+
+namespace
+{
+  using unit::rnd;
+
+  /// A client fed by hand, which records the messages it parses.
+  class FakeClient: public urbi::UAbstractClient
+  {
+  public:
+    FakeClient()
+      : urbi::UAbstractClient("", 0, 1024)
+    {}
+
+    virtual void notifyCallbacks(const urbi::UMessage& msg)
+    {
+      std::ostringstream o;
+      msg.print(o);
+      messages.push_back(o.str());
+    }
+
+    void feed(const std::string& data, size_t chunk)
+    {
+      for (size_t i = 0; i < data.size(); i += chunk)
+        recvData(data.data() + i, std::min(chunk, data.size() - i));
+    }
+
+    virtual void printf(const char*, ...) {}
+    virtual unsigned int getCurrentTime() const { return 0; }
+    virtual void setKeepAliveCheck(unsigned, unsigned) {}
+    virtual error_type effectiveSend(const void*, size_t) { return 0; }
+    virtual void waitForKernelVersion() const {}
+
+    std::vector<std::string> messages;
+  };
+
+  /// The parser before the scanner, on a complete stream.
+  static std::vector<std::string>
+  reference(urbi::UAbstractClient& client, std::string data)
+  {
+    std::vector<std::string> res;
+    size_t pos = 0;
+    while (data.find('\n', pos) != std::string::npos)
+    {
+      if (data[pos] == '\n')
+      {
+        ++pos;
+        continue;
+      }
+      const char* start = data.c_str() + pos;
+      int timestamp;
+      char tag[urbi::UAbstractClient::URBI_MAX_TAG_LENGTH];
+      if (2 != sscanf(start, "[%d:%63[A-Za-z0-9_.]]", &timestamp, tag))
+      {
+        if (1 == sscanf(start, "[%d]", &timestamp))
+          tag[0] = 0;
+        else
+          pabort("invalid header: " << start);
+      }
+      size_t p = data.find(']', pos) + 1;
+      while (data[p] == ' ')
+        ++p;
+      size_t command = p;
+      bool system = data[p] == '!' || data[p] == '*';
+      bool inString = false;
+      int nBracket = 0;
+      urbi::binaries_type bins;
+      for (;; ++p)
+      {
+        char c = data[p];
+        if (inString)
+        {
+          if (c == '\\')
+            ++p;
+          else if (c == '"')
+            inString = false;
+          continue;
+        }
+        if (c == '"')
+          inString = true;
+        else if (c == '[')
+          ++nBracket;
+        else if (c == ']')
+          --nBracket;
+        else if (c == '\n')
+        {
+          std::string text(data, command, p - command);
+          res.push_back(libport::format("%s", urbi::UMessage(client,
+                                                             timestamp, tag,
+                                                             text, bins)));
+          pos = p + 1;
+          break;
+        }
+        else if (!system && !strncmp(data.c_str() + p - 3, "BIN ", 4))
+        {
+          size_t size = strtol(data.c_str() + p + 1, 0, 0);
+          p = data.find('\n', p) + 1;
+          void* bin = malloc(size);
+          memcpy(bin, data.data() + p, size);
+          bins.push_back(urbi::BinaryData(bin, size));
+          data.erase(p, size);
+          if (!nBracket)
+          {
+            std::string text(data, command, p - command);
+            res.push_back(libport::format("%s",
+                                          urbi::UMessage(client,
+                                                         timestamp, tag,
+                                                         text, bins)));
+            pos = p;
+            break;
+          }
+          --p;
+        }
+      }
+      foreach (urbi::BinaryData& b, bins)
+        b.clear();
+    }
+    return res;
+  }
+
+  static std::string
+  random_tag()
+  {
+    static const char chars[] =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_.";
+    std::string res;
+    for (size_t n = 1 + rnd(20); n; --n)
+      res += chars[rnd(sizeof chars - 1)];
+    return res;
+  }
+
+  static std::string
+  random_value(unsigned depth = 0)
+  {
+    switch (rnd(depth < 3 ? 5 : 3))
+    {
+    case 0:
+      return libport::format("%s", rnd(100000) / 100.0);
+    case 1:
+    {
+      static const char chars[] = "ab []N\n:";
+      static const char* escaped[] = { "\\\"", "\\\\", "BIN 3 ", "\\n" };
+      std::string res = "\"";
+      for (size_t n = rnd(30); n; --n)
+        if (rnd(4))
+          res += chars[rnd(sizeof chars - 1)];
+        else
+          res += escaped[rnd(4)];
+      return res + "\"";
+    }
+    case 2:
+    {
+      std::string res = libport::format("BIN %s raw\n", 1 + rnd(40));
+      size_t size = strtol(res.c_str() + 4, 0, 0);
+      for (size_t i = 0; i < size; ++i)
+        res += char(rnd(256));
+      return res;
+    }
+    default:
+    {
+      std::string res = "[";
+      for (size_t n = rnd(5); n; --n)
+        res += random_value(depth + 1) + (n == 1 ? "" : ", ");
+      return res + "]";
+    }
+    }
+  }
+
+  static std::string
+  random_message()
+  {
+    std::string res = rnd(4)
+      ? libport::format("[%08d:%s] ", rnd(100000000), random_tag())
+      : libport::format("[%08d] ", rnd(100000000));
+    switch (rnd(4))
+    {
+    case 0:
+      res += "*** system [message] with BIN 5 inside";
+      break;
+    case 1:
+      res += "!!! error: [unexpected] `BIN'";
+      break;
+    default:
+      res += random_value();
+      break;
+    }
+    res += "\n";
+    if (!rnd(8))
+      res += "\n";
+    return res;
+  }
+
+  static std::string
+  random_stream(size_t n)
+  {
+    std::string res;
+    while (n--)
+      res += random_message();
+    return res;
+  }
+}
+
+BEGIN_TEST
+
+GD_FINFO("scanner: %s", urbi::scanner::flavor());
+
+// The scanner and its scalar version.
+for (size_t i = 0; i < 10000; ++i)
+{
+  std::string s;
+  for (size_t n = rnd(200); n; --n)
+    s += rnd(4) ? 'x' : "\n\"[]N\\ BI"[rnd(9)];
+  size_t o = rnd(s.size() + 1);
+  assert_eq(urbi::scanner::find_special(s.c_str() + o, s.size() - o),
+            urbi::scanner::find_special_scalar(s.c_str() + o,
+                                               s.size() - o));
+  assert_eq(urbi::scanner::find_string_special(s.c_str() + o,
+                                               s.size() - o),
+            urbi::scanner::find_string_special_scalar(s.c_str() + o,
+                                                      s.size() - o));
+}
+
+// The header parser and sscanf.
+for (size_t i = 0; i < 10000; ++i)
+{
+  std::string s;
+  for (size_t n = rnd(20); n; --n)
+    s += "[0123:-+ ab_.]9\n"[rnd(16)];
+  int t1 = -1, t2 = -1;
+  char tag1[64] = "", tag2[64] = "";
+  int r1 = sscanf(s.c_str(), "[%d:%63[A-Za-z0-9_.]]", &t1, tag1);
+  if (r1 != 2)
+    r1 = sscanf(s.c_str(), "[%d]", &t1) == 1;
+  int r2 = urbi::scanner::scan_header(s.c_str(), t2, tag2, sizeof tag2);
+  assert_eq(r1, r2);
+  if (r1)
+    assert_eq(t1, t2);
+  if (r1 == 2)
+    assert_eq(std::string(tag1), std::string(tag2));
+}
+
+// The parser, on random streams received in random chunks.
+for (size_t i = 0; i < 200; ++i)
+{
+  std::string stream = random_stream(1 + rnd(50));
+  FakeClient c;
+  c.feed(stream, 1 + rnd(i % 2 ? 8 : 512));
+  std::vector<std::string> expected = reference(c, stream);
+  assert_eq(c.messages.size(), expected.size());
+  for (size_t j = 0; j < expected.size(); ++j)
+    assert_eq(c.messages[j], expected[j]);
+}
+
+END_TEST
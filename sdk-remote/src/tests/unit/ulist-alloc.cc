@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+// Count the allocations needed to build, parse, copy and destroy
+// lists of floats, as sent by sensors, with the elements allocated
+// one by one (as UList did before its blocks, and as user code that
+// fills UList::array by hand still does) and by the list itself:
+// the blocks must need fewer.
+
+#include <cstdlib>
+#include <new>
+
+#include <libport/cassert>
+#include <libport/foreach.hh>
+#include <libport/format.hh>
+
+#include <urbi/ubinary.hh>
+#include <urbi/ulist.hh>
+#include <urbi/uvalue.hh>
+#include <bin/unit.hh>
+
+static size_t allocations = 0;
+
+void*
+operator new(size_t size) throw (std::bad_alloc)
+{
+  ++allocations;
+  if (void* res = malloc(size))
+    return res;
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) throw ()
+{
+  free(p);
+}
+
+void*
+operator new[](size_t size) throw (std::bad_alloc)
+{
+  return operator new(size);
+}
+
+void
+operator delete[](void* p) throw ()
+{
+  operator delete(p);
+}
+
+namespace
+{
+  /// Log and return the number of allocations since the last call.
+  static size_t
+  count(const std::string& what, size_t n)
+  {
+    static size_t last = 0;
+    size_t res = allocations - last;
+    GD_FINFO("%s, %s floats: %s allocations", what, n, res);
+    last = allocations;
+    return res;
+  }
+
+  static std::string
+  payload(size_t n)
+  {
+    std::string res = "[";
+    for (size_t i = 0; i < n; ++i)
+      res += libport::format("%s%s", i ? ", " : "", i * 0.125);
+    return res + "]";
+  }
+}
+
+BEGIN_TEST
+
+static const size_t sizes[] = { 3, 16, 1000 };
+foreach (size_t n, sizes)
+{
+  std::string s = payload(n);
+  count("start", 0);
+
+  {
+    urbi::UList l;
+    for (size_t i = 0; i < n; ++i)
+      l.array.push_back(new urbi::UValue(i * 0.125));
+  }
+  size_t before = count("build and destroy, one by one", n);
+
+  {
+    urbi::UList l;
+    l.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+      l.push_back(i * 0.125);
+  }
+  size_t after = count("build and destroy, in blocks", n);
+  assert_lt(after, before);
+
+  {
+    urbi::UValue v;
+    urbi::binaries_type bins;
+    urbi::binaries_type::const_iterator binpos = bins.begin();
+    v.parse(s.c_str(), 0, bins, binpos);
+    assert_eq(v.list->size(), n);
+    count("parse and destroy, in blocks", n);
+
+    urbi::UValue copy(v);
+    count("copy, in blocks", n);
+  }
+  count("destroy", n);
+}
+
+// Elements allocated by hand and by the list can be mixed.
+{
+  urbi::UList l;
+  l.push_back(1);
+  l.array.push_back(new urbi::UValue(2));
+  l.append() = 3;
+  assert_eq(l.size(), 3u);
+  assert_eq(l[1].val, 2);
+
+  urbi::UValue v(l);
+  urbi::UList shorter;
+  shorter.push_back(4);
+  v = shorter;
+  v = urbi::UValue(l);
+  assert_eq(v.list->size(), 3u);
+  assert_eq((*v.list)[2].val, 3);
+}
+
+END_TEST
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+// Check that UValue::parse reads numbers exactly as strtod does in
+// the C locale, and that what UValue::print outputs is parsed back
+// to the same value.  Check strings, lists and dictionaries too.
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <libport/cassert>
+#include <libport/cstdlib>
+#include <libport/format.hh>
+
+#include <urbi/ubinary.hh>
+#include <urbi/ulist.hh>
+#include <urbi/uvalue.hh>
+#include <bin/unit.hh>
+
+namespace
+{
+  /// Parse \a s into \a v, return the end position.
+  static int
+  parse(urbi::UValue& v, const std::string& s)
+  {
+    urbi::binaries_type bins;
+    urbi::binaries_type::const_iterator binpos = bins.begin();
+    return v.parse(s.c_str(), 0, bins, binpos);
+  }
+
+  static double
+  random_double()
+  {
+    switch (rand() % 3)
+    {
+    case 0:
+      return (rand() - RAND_MAX / 2) / 1000.0;
+    case 1:
+      return rand() % 100000 / 100.0;
+    default:
+      return ldexp(double(rand()) / RAND_MAX, rand() % 200 - 100);
+    }
+  }
+}
+
+BEGIN_TEST
+
+// Numbers, in various notations.
+static const char* formats[] =
+  { "%.17g", "%.6f", "%g", "%.3e", "%.0f", "%.21g", "%.15g" };
+for (size_t i = 0; i < 10000; ++i)
+{
+  double d = random_double();
+  std::string s = libport::format(formats[i % 7], d);
+  urbi::UValue v;
+  int end = parse(v, s);
+  char* e;
+  double expected = libport::strtod_c(s.c_str(), &e);
+  assert_eq(end, e - s.c_str());
+  assert_eq(v.type, urbi::DATA_DOUBLE);
+  assert(!memcmp(&v.val, &expected, sizeof expected));
+
+  // Round-trip through print.
+  std::ostringstream o;
+  v.print(o);
+  urbi::UValue v2;
+  parse(v2, o.str());
+  assert(!memcmp(&v2.val, &v.val, sizeof v.val));
+}
+
+// Strings, with and without escapes.
+{
+  urbi::UValue v;
+  assert_eq(parse(v, "\"foo bar\""), 9);
+  assert_eq(*v.stringValue, "foo bar");
+  urbi::UValue v2;
+  assert_eq(parse(v2, "\"a\\\"b\\\\c\\n\""), 12);
+  assert_eq(*v2.stringValue, "a\"b\\c\n");
+}
+
+// Lists and dictionaries, mixed.
+{
+  urbi::UValue v;
+  std::string s = "[1, -2.5, \"three\", [], [\"x\" => .5e1], true]";
+  assert_eq(parse(v, s), int(s.size()));
+  assert_eq(v.type, urbi::DATA_LIST);
+  assert_eq(v.list->size(), 6u);
+  assert_eq((*v.list)[1].val, -2.5);
+  assert_eq((*v.list)[4].dictionary->find("x")->second.val, 5);
+  assert_eq((*v.list)[5].val, 1);
+}
+
+END_TEST
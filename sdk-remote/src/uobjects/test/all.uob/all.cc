@@ -150,6 +150,7 @@ public:
        transmitD, transmitS, transmitL, transmitM, transmitB,
        transmitI, transmitSnd, transmitO,
        transmitVector, transmitMatrix);
+    UBindFunction(all, binarySize);
     UBindFunction(all, emitO);
     UBindFunctions
       (all,
@@ -880,6 +881,13 @@ public:
     return im;
   }
 
+  /// The size of the binary \a v, to measure the cost of passing it.
+  size_t binarySize(const urbi::UValue& v) const
+  {
+    threadCheck();
+    return v.type == urbi::DATA_BINARY ? v.binary->common.size : 0;
+  }
+
   urbi::UObject* transmitO(UObject* o) const
   {
     return o;
@@ -46,6 +46,8 @@ public:
                           LOCK_FUNCTION_DROP);
     UBindThreadedFunction(Threaded, lockFunctionKeepOneDelayOp,
                           LOCK_FUNCTION_KEEP_ONE);
+    UBindThreadedFunction(Threaded, lockFunctionCoalesceDelayOp,
+                          LOCK_FUNCTION_COALESCE);
     UBindVar(Threaded, updated);
     updated = 0;
     UBindVar(Threaded, timerUpdated);
@@ -64,6 +66,7 @@ public:
   void lockFunctionDelayOp(int id, int delay)        { delayOp(id, delay);}
   void lockFunctionDropDelayOp(int id, int delay)    { delayOp(id, delay);}
   void lockFunctionKeepOneDelayOp(int id, int delay) { delayOp(id, delay);}
+  void lockFunctionCoalesceDelayOp(int id, int delay) { delayOp(id, delay);}
   void lockClassDelayOp(int id, int delay)           { delayOp(id, delay);}
   void lockModuleDelayOp(int id, int delay)          { delayOp(id, delay);}
 
@@ -7,6 +7,7 @@
 ## See the LICENSE file for more information.
 
 bin_PROGRAMS +=					\
+  utils/urbi-convert-bench			\
   utils/urbi-cycle				\
   utils/urbi-reverse				\
   utils/urbi-scale
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+#include <libport/cstdlib>
+#include <libport/cstdio>
+#include <libport/cstring>
+#include <libport/utime.hh>
+#include <algorithm>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include "urbi/frame-pool.hh"
+#include "urbi/uconversion.hh"
+#include "urbi/uimage.hh"
+#include "liburbi/image-kernels.hh"
+
+void
+usage(const char* name, int status)
+{
+  printf("usage %s [threads [frames]]\n"
+         "\tmeasure the time taken by the image kernels, scalar and\n"
+         "\tvectorized, on 640x480 images, then the frame rate of\n"
+         "\turbi::convert on 640x480 and 1280x720 images, with 1 to\n"
+         "\tthreads threads (default: the number of cores), over\n"
+         "\tframes frames (default: 200)\n", name);
+  if (status)
+    exit(status);
+}
+
+/// A conversion to measure.
+struct Conversion
+{
+  const char* name;
+  urbi::UImageFormat source;
+  urbi::UImageFormat dest;
+  /// The sizes of the source divided by those of the destination.
+  size_t shrink;
+  /// The filter, if scaled.  Omitted, SCALE_AUTO.
+  urbi::UScaleFilter filter;
+};
+
+static const Conversion conversions[] =
+  {
+    { "nv12 -> rgb",            urbi::IMAGE_NV12,   urbi::IMAGE_RGB,   1 },
+    { "yuv422 -> rgb",          urbi::IMAGE_YUV422, urbi::IMAGE_RGB,   1 },
+    { "rgb -> grey8",           urbi::IMAGE_RGB,    urbi::IMAGE_GREY8, 1 },
+    { "rgb -> yuv420_planar",   urbi::IMAGE_RGB,
+      urbi::IMAGE_YUV420_PLANAR, 1 },
+    { "rgb -> jpeg",            urbi::IMAGE_RGB,    urbi::IMAGE_JPEG,  1 },
+    { "rgb -> rgb (1/2, area)", urbi::IMAGE_RGB,    urbi::IMAGE_RGB,   2,
+      urbi::SCALE_AREA },
+    { "rgb -> rgb (1/2, bilinear)", urbi::IMAGE_RGB,
+      urbi::IMAGE_RGB, 2, urbi::SCALE_BILINEAR },
+    { "nv12 -> rgb (1/2 size)", urbi::IMAGE_NV12,   urbi::IMAGE_RGB,   2 },
+    { "jpeg -> rgb",            urbi::IMAGE_JPEG,   urbi::IMAGE_RGB,   1 },
+    { "jpeg -> rgb (1/4 size)", urbi::IMAGE_JPEG,   urbi::IMAGE_RGB,   4 },
+  };
+
+/// A kernel to measure, and its scalar version if any.
+struct Kernel
+{
+  const char* name;
+  urbi::image_kernels::kernel_type kernel;
+  urbi::image_kernels::kernel_type scalar;
+  /// The sizes of the pixels of the source and of the destination, in
+  /// half bytes.
+  size_t source_size;
+  size_t dest_size;
+};
+
+static const Kernel kernels[] =
+  {
+    { "nv12 -> grey8",    urbi::image_kernels::nv12_to_grey8,
+      urbi::image_kernels::nv12_to_grey8_scalar, 3, 2 },
+    { "nv12 -> rgb",      urbi::image_kernels::nv12_to_rgb,
+      urbi::image_kernels::nv12_to_rgb_scalar, 3, 6 },
+    { "rgb -> grey8",     urbi::image_kernels::rgb_to_grey8,
+      urbi::image_kernels::rgb_to_grey8_scalar, 6, 2 },
+    { "yuv420 -> ycbcr",  urbi::image_kernels::yuv420_to_ycbcr, 0, 3, 6 },
+    { "yuv422 -> rgb",    urbi::image_kernels::yuv422_to_rgb,
+      urbi::image_kernels::yuv422_to_rgb_scalar, 4, 6 },
+  };
+
+/// The time taken by \a k on a \a w x \a h image, in microseconds per
+/// frame, over \a frames frames.
+static double
+kernel_time(urbi::image_kernels::kernel_type k, const Kernel& info,
+            size_t w, size_t h, size_t frames)
+{
+  std::vector<urbi::byte> src(w * h * info.source_size / 2);
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = rand();
+  std::vector<urbi::byte> dest(w * h * info.dest_size / 2);
+  libport::utime_t start = libport::utime();
+  for (size_t i = 0; i < frames; ++i)
+    k(&src[0], w, h, 0, h, &dest[0]);
+  return double(libport::utime() - start) / frames;
+}
+
+/// The size of a \a w x \a h image in \a format.
+static size_t
+image_size(urbi::UImageFormat format, size_t w, size_t h)
+{
+  switch (format)
+  {
+  case urbi::IMAGE_GREY8:
+    return w * h;
+  case urbi::IMAGE_YUV422:
+    return w * h * 2;
+  case urbi::IMAGE_NV12:
+  case urbi::IMAGE_YUV420_PLANAR:
+    return w * h * 3 / 2;
+  default:
+    return w * h * 3;
+  }
+}
+
+/// The number of frames converted per second.
+static double
+fps(const Conversion& c, size_t w, size_t h, size_t threads, size_t frames)
+{
+  // Gradients, which compress like pictures, with some noise.
+  std::vector<urbi::byte> src(image_size(c.source, w, h));
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = i % w / 4 + i / w % 64 + rand() % 8;
+  urbi::UImage in;
+  in.data = &src[0];
+  in.size = src.size();
+  in.width = w;
+  in.height = h;
+  in.imageFormat = c.source;
+  urbi::UImage jpeg;
+  if (c.source == urbi::IMAGE_JPEG)
+  {
+    in.imageFormat = urbi::IMAGE_RGB;
+    jpeg.imageFormat = urbi::IMAGE_JPEG;
+    urbi::convert(in, jpeg);
+    in.data = jpeg.data;
+    in.size = jpeg.size;
+    in.imageFormat = urbi::IMAGE_JPEG;
+  }
+
+  // Let convert allocate the destination once.
+  urbi::UImage out;
+  out.imageFormat = c.dest;
+  out.width = w / c.shrink;
+  out.height = h / c.shrink;
+  urbi::ConversionPolicy policy(threads);
+  policy.filter = c.filter;
+  urbi::convert(in, out, policy);
+
+  libport::utime_t start = libport::utime();
+  for (size_t i = 0; i < frames; ++i)
+    urbi::convert(in, out, policy);
+  libport::utime_t duration = libport::utime() - start;
+  free(out.data);
+  free(jpeg.data);
+  return duration ? frames * 1000000. / duration : 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  if (1 < argc && !strcmp(argv[1], "--help"))
+  {
+    usage(argv[0], 0);
+    return 0;
+  }
+  size_t threads = std::max(boost::thread::hardware_concurrency(), 1u);
+  size_t frames = 200;
+  if (1 < argc)
+    threads = strtol(argv[1], NULL, 0);
+  if (2 < argc)
+    frames = strtol(argv[2], NULL, 0);
+  if (!threads || !frames)
+    usage(argv[0], 1);
+
+  static const size_t sizes[][2] = { { 640, 480 }, { 1280, 720 } };
+  printf("kernels: %s\n", urbi::image_kernels::flavor());
+  printf("\n%-26s %8s %8s\n", "640x480, us per frame", "scalar", "vector");
+  for (size_t i = 0; i < sizeof kernels / sizeof *kernels; ++i)
+  {
+    const Kernel& k = kernels[i];
+    printf("%-26s", k.name);
+    if (k.scalar)
+      printf(" %8.1f", kernel_time(k.scalar, k, 640, 480, frames));
+    else
+      printf(" %8s", "-");
+    printf(" %8.1f\n", kernel_time(k.kernel, k, 640, 480, frames));
+  }
+  for (size_t s = 0; s < sizeof sizes / sizeof *sizes; ++s)
+  {
+    size_t w = sizes[s][0];
+    size_t h = sizes[s][1];
+    printf("\n%zux%zu%*s", w, h, 16, "threads:");
+    for (size_t t = 1; t <= threads; ++t)
+      printf(" %8zu", t);
+    printf("\n");
+    for (size_t i = 0; i < sizeof conversions / sizeof *conversions; ++i)
+    {
+      printf("%-26s", conversions[i].name);
+      for (size_t t = 1; t <= threads; ++t)
+        printf(" %8.1f", fps(conversions[i], w, h, t, frames));
+      printf("\n");
+    }
+  }
+  urbi::frame_pool::Stats pool = urbi::frame_pool::stats();
+  printf("\nframe pool: %zu hits, %zu misses, %zu buffers kept (%zu bytes)\n",
+         pool.hits, pool.misses, pool.buffers, pool.bytes);
+  return 0;
+}
@@ -251,16 +251,22 @@ namespace ast
     FLAVOR_DEFAULT(semicolon);
     FLAVOR_CHECK1("at", semicolon);
 
-    DISPATCH_IDS(args, sync, async);
+    DISPATCH_IDS(args, sync, async, coalesce);
     if (sync && async)
       SYNTAX_ERROR(loc, "incompatible keywords: `sync' and `async'");
-
-    return new At(loc, flavor, flavor_loc,
-                  sync,
-                  make_strip(cond),
-                  make_scope(loc, body),
-                  onleave ? make_scope(loc, onleave) : make_scope(loc),
-                  duration);
+    // A coalesced condition is not evaluated by the job that changed
+    // its dependencies, so there is nothing to be synchronous with.
+    if (sync && coalesce)
+      SYNTAX_ERROR(loc, "incompatible keywords: `sync' and `coalesce'");
+
+    rAt res = new At(loc, flavor, flavor_loc,
+                     sync,
+                     make_strip(cond),
+                     make_scope(loc, body),
+                     onleave ? make_scope(loc, onleave) : make_scope(loc),
+                     duration);
+    res->coalesce_set(coalesce);
+    return res;
   }
 
   rExp
@@ -61,6 +61,7 @@
 #include <urbi/object/object.hh>
 #include <urbi/object/float.hh>
 
+#include <eval/bytecode.hh>
 #include <object/system.hh>
 #include <urbi/export.hh>
 #include <urbi/package-info.hh>
@@ -311,6 +312,8 @@ namespace urbi
 #endif
     /// The size of the stacks.
     size_t arg_stack_size = 0;
+    /// Whether to report the time spent loading the library.
+    bool startup_report = false;
 
     // Parse the command line.
     LoopData data;
@@ -320,10 +323,14 @@ namespace urbi
       arg_interactive("read stdin in a nonblocking way", "interactive", 'i'),
       arg_no_net("ignored for backward compatibility", "no-network", 'n'),
       arg_no_banner("do not send the banner to incoming clients", "quiet", 'q'),
-      arg_root("output Urbi root and exit", "print-root");
+      arg_root("output Urbi root and exit", "print-root"),
+      arg_startup_report("report the time spent loading each file at startup",
+                         "startup-report");
 
     libport::OptionValue
-      arg_stack("set the job stack size in KB", "stack-size", 's', "SIZE");
+      arg_stack("set the job stack size in KB", "stack-size", 's', "SIZE"),
+      arg_engine("select the evaluation engine: ast (default) or bytecode",
+                 "engine", '\0', "ENGINE");
 
     libport::OptionsEnd arg_remaining(true);
     {
@@ -339,6 +346,8 @@ namespace urbi
 # endif
         << arg_fast
         << arg_stack
+        << arg_engine
+        << arg_startup_report
         << arg_no_banner
         << "Networking:"
         << libport::opts::host_l
@@ -376,6 +385,11 @@ namespace urbi
       data.fast = arg_fast.get();
 
       arg_stack_size = arg_stack.get<size_t>(static_cast<size_t>(0));
+      startup_report = arg_startup_report.get();
+
+      if (arg_engine.filled()
+          && !eval::engine_set(arg_engine.value()))
+        URBI_EXIT(EX_USAGE, "invalid engine: %s", arg_engine.value());
 
      // Since arg_remaining ate everything, args should be empty
      // unless the user made a mistake.
@@ -408,6 +422,11 @@ namespace urbi
     if (IF_OPTION_PARSER(!arg_stack.filled() && , )  getenv("URBI_STACK_SIZE"))
       arg_stack_size = libport::convert_envvar<size_t> ("URBI_STACK_SIZE");
 
+    // If not defined in command line, use the envvar.
+    if (IF_OPTION_PARSER(!arg_engine.filled() && , )  getenv("URBI_ENGINE")
+        && !eval::engine_set(getenv("URBI_ENGINE")))
+      URBI_EXIT(EX_USAGE, "invalid engine: %s", getenv("URBI_ENGINE"));
+
     if (arg_stack_size)
     {
       // Make sure the result is a multiple of the page size.  This
@@ -474,7 +493,15 @@ namespace urbi
     object::system_class->slot_set_value(SYMBOL(fast),
                                    object::to_urbi(data.fast),
                                    true);
+    object::system_class->slot_set_value(SYMBOL(engine),
+                                   object::to_urbi(
+                                     std::string(eval::engine_name())),
+                                   true);
+    if (startup_report)
+      object::load_report_start();
     s.initialize(data.interactive);
+    if (startup_report)
+      object::load_report(std::cerr);
 
     /*--------------.
     | --port-file.  |
@@ -19,19 +19,25 @@
 #include <ast/all.hh>
 #include <ast/print.hh> // For pabort.
 
+#include <urbi/kernel/userver.hh>
+
 #include <urbi/object/dictionary.hh>
 #include <urbi/object/event.hh>
 #include <urbi/object/event-handler.hh>
 #include <urbi/object/float.hh>
 #include <urbi/object/global.hh>
 #include <urbi/object/list.hh>
+#include <urbi/object/lookup-cache.hxx>
 #include <urbi/object/tag.hh>
 
 #include <object/code.hh>
 
 #include <eval/ast.hh>
+#include <eval/bytecode.hh>
 #include <eval/call.hh>
+#include <eval/jump.hh>
 #include <eval/raise.hh>
+#include <eval/send-message.hh>
 
 namespace eval
 {
@@ -65,6 +71,10 @@ namespace eval
     static void
     at_run(WatchEventData* data,
            const object::objects_type& = object::objects_type());
+    static void
+    at_dirty(WatchEventData* data,
+             const object::objects_type& = object::objects_type());
+    static void at_coalesced(WatchEventData* data, object::rEvent ward);
 
 
     static object::rCode
@@ -83,8 +93,10 @@ namespace eval
     visit(const ast::Node* n)
 
     VISIT(And);
+    VISIT(Break);
     VISIT(Call);
     VISIT(CallMsg);
+    VISIT(Continue);
     VISIT(Dictionary);
     VISIT(Do);
     VISIT(Event);
@@ -101,6 +113,7 @@ namespace eval
     VISIT(Pipe);
     VISIT(Property);
     VISIT(PropertyWrite);
+    VISIT(Return);
     VISIT(Routine);
     VISIT(Scope);
     VISIT(Stmt);
@@ -203,20 +216,33 @@ namespace eval
 
   struct Visitor::WatchEventData
   {
-    WatchEventData(urbi::object::rEvent ev, object::rCode e)
+    WatchEventData(urbi::object::rEvent ev, object::rCode e,
+                   libport::Symbol n, bool c = false)
       : event(ev.get())
       , exp(e)
+      , name(n)
       , current(0)
       , subscriptions()
+      , coalesce(c)
+      , dirty(false)
       {}
     ~WatchEventData();
     object::Event* event;
     // Same value as event, used when watching to keep it alive
     object::rEvent event_ward;
     object::rCode exp;
+    /// The name of the condition, cached in its AST node:
+    /// pretty-printing the AST is way too costly.
+    libport::Symbol name;
     object::rEventHandler current;
     std::vector<object::rSubscription> subscriptions;
+    /// The profile of the job that created the condition, if it is
+    /// profiling: it is specific to this instance.
     object::rProfile profile;
+    /// Whether the condition is re-evaluated at most once per cycle.
+    bool coalesce;
+    /// Whether a re-evaluation is already scheduled.
+    bool dirty;
   };
 
 
@@ -246,17 +272,14 @@ namespace eval
       bool interruptible = r.non_interruptible_get();
       try
       {
-        const ast::Routine& ast = dynamic_cast<const ast::Routine&>
-          (*data->exp->ast_get().get());
-        libport::Symbol name(libport::format("at: %s", *ast.body_get()));
         if (!r.is_profiling() && data->profile)
         {
           profiled = true;
-          r.profile_start(data->profile, name, data->exp.get());
+          r.profile_start(data->profile, data->name, data->exp.get());
         }
         r.dependencies_log_set(true);
         r.non_interruptible_set(true);
-        v = eval::call_apply(r, data->exp, name, args);
+        v = eval::call_apply(r, data->exp, data->name, args);
         r.non_interruptible_set(interruptible);
         r.dependencies_log_set(false);
         if (profiled)
@@ -270,28 +293,32 @@ namespace eval
           r.profile_stop();
         throw;
       }
+      // Update the subscriptions incrementally: keep those still
+      // needed, leaving in the dependencies only the new ones.  The
+      // order of the subscriptions does not matter, so remove the
+      // stale ones by swapping them with the last one.
+      Job::dependencies_type& deps = r.dependencies();
+      std::vector<object::rSubscription>& subs = data->subscriptions;
       unsigned hooks_removed = 0;
-      std::vector<object::rSubscription>::iterator it
-        = data->subscriptions.begin();
-      while (it != data->subscriptions.end())
+      for (size_t i = 0; i < subs.size(); )
       {
-        Job::dependencies_type::iterator find =
-          r.dependencies().find((*it)->event_);
-        if (find != r.dependencies().end())
+        Job::dependencies_type::iterator find = deps.find(subs[i]->event_);
+        if (find != deps.end())
         {
-          r.dependencies().erase(find);
-          ++it;
+          deps.erase(find);
+          ++i;
         }
         else
         {
           ++hooks_removed;
-          (*it)->stop();
-          it = data->subscriptions.erase(it);
+          subs[i]->stop();
+          std::swap(subs[i], subs.back());
+          subs.pop_back();
         }
       }
       GD_FINFO_DEBUG("Watch event has %s hooks: %s new, %s removed.",
-                     r.dependencies().size() + data->subscriptions.size(),
-                     r.dependencies().size(), hooks_removed);
+                     deps.size() + subs.size(),
+                     deps.size(), hooks_removed);
     }
     return v;
   }
@@ -378,7 +405,9 @@ namespace eval
 
     bool v = object::from_urbi<bool>(res);
     foreach (object::Event* evt, r.dependencies())
-      data->subscriptions << evt->onEvent(boost::bind(at_run, data, _1));
+      data->subscriptions
+        << evt->onEvent(boost::bind(data->coalesce ? at_dirty : at_run,
+                                    data, _1));
     r.dependencies_clear();
 
     // Check for different evaluation of the condition.
@@ -395,7 +424,43 @@ namespace eval
     }
   }
 
-#define URBI_EVENT_VISIT(Type, Fun)                                     \
+  /// A dependency of a coalesced condition changed: schedule its
+  /// re-evaluation, unless it already is.  All the changes that occur
+  /// until the next cycle are handled by a single evaluation.
+  inline void
+  Visitor::at_dirty(WatchEventData* data, const object::objects_type&)
+  {
+    if (data->dirty)
+      return;
+    data->dirty = true;
+    // Keep the event, hence data, alive until the evaluation.
+    ::kernel::server().schedule_fast(boost::bind(at_coalesced, data,
+                                                 object::rEvent(data->event)));
+  }
+
+  void
+  Visitor::at_coalesced(WatchEventData* data, object::rEvent)
+  {
+    GD_CATEGORY(Urbi.At);
+    data->dirty = false;
+    // The at was stopped in the meanwhile.
+    if (!data->event_ward)
+      return;
+    GD_FPUSH_TRACE("Evaluating coalesced condition: %s",
+                   data->exp->body_string());
+    try
+    {
+      at_run(data);
+    }
+    catch (const object::UrbiException& e)
+    {
+      // No one to report to, as when the condition is evaluated by
+      // the job that changed it and that job is detached.
+      eval::show_exception(e);
+    }
+  }
+
+#define URBI_EVENT_VISIT(Type, Fun, Coalesce)                           \
   LIBPORT_SPEED_ALWAYS_INLINE rObject                                   \
   Visitor::visit(const ast::Type* e)                                    \
   {                                                                     \
@@ -406,7 +471,14 @@ namespace eval
     object::rEvent res = new object::Event;                             \
     GD_CATEGORY(Urbi.At);                                               \
     GD_FPUSH_TRACE("Create watch event: %s : %s", code->body_string(), res); \
-    WatchEventData* data = new WatchEventData(res, code);               \
+    libport::Symbol& name = e->condition_name_get();                    \
+    if (name.empty())                                                   \
+      name = libport::Symbol(                                           \
+        libport::format("at: %s",                                       \
+                        *dynamic_cast<const ast::Routine&>              \
+                        (*code->ast_get().get()).body_get()));          \
+    WatchEventData* data =                                              \
+      new WatchEventData(res, code, name, Coalesce);                    \
     data->profile = this_.profile_get();                                \
     res->destructed = boost::bind(&watch_stop, data);  \
     /* Maintain that event alive as long as it is subscribed to. */     \
@@ -418,37 +490,95 @@ namespace eval
     return res;                                                         \
   }
 
-  URBI_EVENT_VISIT(Watch, watch_run);
-  URBI_EVENT_VISIT(Event, at_run);
+  URBI_EVENT_VISIT(Watch, watch_run, false);
+  URBI_EVENT_VISIT(Event, at_run, e->coalesce_get());
 #undef URBI_EVENT_VISIT
 
-  LIBPORT_SPEED_ALWAYS_INLINE rObject
-  Visitor::visit(const ast::Call* e)
+  /// Look up \a s in \a tgt using the inline cache of \a e.  The
+  /// cache is bypassed when dependencies are recorded, since a cache
+  /// hit would not register them.
+  static inline object::Object::location_type
+  cached_slot_locate(Job& job, const ast::Call* e,
+                     const rObject& tgt, libport::Symbol s, bool fallback)
   {
-    // The invoked slot (probably a function).
-    const ast::rConstExp& ast_tgt = e->target_get();
-    rObject tgt = ast(this_, ast_tgt.get());
-    bool implicit = e->target_implicit();
-    if (implicit)
-    { // If target is implicit, we can use our imports.
-      rObject res;
-      libport::Symbol s = e->name_get();
-      // FIXME: this sucks, but since a=b is desugared into updateSlot, no
-      // way to make the difference.
-      bool updateMode = (s == SYMBOL(updateSlot));
-      object::objects_type args;
-      if (updateMode)
-      {
-        // Replace current target ('updateSlot') with first argument
-        // of updateSlot call.
-        strict_args(this_, args, *e->arguments_get());
-        if (args.size() != 2)
-          runner::raise_arity_error(2, args.size());
-        object::rString rs = args[0]->as<object::String>();
-        if (!rs)
-          runner::raise_argument_type_error(1, args[0], object::String::proto);
-        s = libport::Symbol(rs->value_get());
-      }
+    if (job.dependencies_log_get())
+      return tgt->slot_locate(s, fallback);
+    return e->cache_get().slot_locate(tgt.get(), s, fallback);
+  }
+
+  /// The value of \a e if it is a Float literal, evaluated without
+  /// boxing it, otherwise the value of \a e evaluated the regular way.
+  /// \return  whether \a e is a literal.
+  static inline bool
+  unboxed_arg(Job& job, const ast::Exp* e,
+              object::Float::value_type& v, rObject& res)
+  {
+    if (const ast::Float* f = dynamic_cast<const ast::Float*>(e))
+    {
+      v = f->value_get();
+      return true;
+    }
+    res = ast(job, e);
+    return false;
+  }
+
+  /// Evaluate \a e, a call to a binary operator on the Float \a tgt.
+  /// If the operator is one of the Float primitives, compute it on
+  /// the values, so that `i < 1000' allocates nothing and `i + 1'
+  /// only its result.  Otherwise, or if the job is being profiled or
+  /// is logging dependencies, return 0 before evaluating anything.
+  static inline rObject
+  unboxed_call(Job& job, const ast::Call* e, object::Float* tgt)
+  {
+    const ast::exps_type* args = e->arguments_get();
+    if (!args || args->size() != 1
+        || job.dependencies_log_get() || job.is_profiling())
+      return 0;
+    libport::Symbol msg = e->name_get();
+    object::Object::location_type loc =
+      e->cache_get().slot_locate(tgt, msg, true);
+    if (!loc.first)
+      return 0;
+    rObject routine = loc.second;
+    if (object::rSlot s = routine->as<object::Slot>())
+      routine = s->value(tgt);
+    object::Float::unboxed_type op =
+      object::Float::unboxed_operator(routine.get());
+    if (op == object::Float::unboxed_none)
+      return 0;
+
+    object::Float::value_type rhs = 0;
+    rObject arg;
+    if (!unboxed_arg(job, args->front().get(), rhs, arg))
+    {
+      if (object::Float* f = arg->as<object::Float>().get())
+        rhs = f->value_get();
+      else
+        op = object::Float::unboxed_none;
+    }
+    if (op != object::Float::unboxed_none)
+      if (rObject res =
+          object::Float::unboxed_apply(op, tgt->value_get(), rhs))
+        return res;
+
+    // Not computable here, e.g., division by zero or a non-Float
+    // argument: call the primitive on the evaluated argument.
+    if (!arg)
+      arg = new object::Float(rhs);
+    object::objects_type call_args;
+    call_args << tgt << arg;
+    return call_apply(job, routine.get(), msg, call_args, 0,
+                      e->location_get());
+  }
+
+  rObject
+  call_routine(Job& job, const ast::Call* e,
+               rObject& tgt, const ast::exps_type*& args)
+  {
+    libport::Symbol s = e->name_get();
+    args = e->arguments_get();
+    if (e->target_implicit())
+    {
       object::Object::location_type loc;
       // Try looking up on this first
       /* We do not want fallback to take precedence over import.
@@ -457,49 +587,105 @@ namespace eval
       * So fallback in case of implicit target is a bit costly, but that should
       * be rare.
       */
-      loc = tgt->slot_locate(s, false);
+      loc = cached_slot_locate(job, e, tgt, s, false);
       if (!loc.first) // Try import stacks, throw if not found
-        loc = import_stack_lookup(this_.state, s, tgt, false);
+        loc = import_stack_lookup(job.state, s, tgt, false);
       if (!loc.first) // Try this, with fallback
-        loc = tgt->slot_locate(s);
+        loc = cached_slot_locate(job, e, tgt, s, true);
       if (!loc.first)
         runner::raise_lookup_error(s, tgt);
-      if (updateMode)
+      rObject val = loc.second;
+      if (object::rSlot sl = val->as<object::Slot>())
       {
-        tgt->slot_update_with_cow(s, args[1], true, loc);
-        return args[1];
+        job.state.call_stack_get() << std::make_pair(s, e->location_get());
+        FINALLY((( runner::Job&, job)),
+          job.state.call_stack_get().pop_back());
+        val = sl->value(tgt);
       }
       else
       {
-        rObject val = loc.second;
-        if (object::rSlot sl = val->as<object::Slot>())
-        {
-          runner::Job& job = ::kernel::server().getCurrentRunner();
-          job.state.call_stack_get() << std::make_pair(s, e->location_get());
-          FINALLY((( runner::Job&, job)),
-            job.state.call_stack_get().pop_back());
-          val = sl->value(tgt);
-        }
-        else
+        // We bypassed slot_get, so we muste handle slot creation if
+        // dependency tracking is on.
+        if (job.dependencies_log_get())
         {
-          // We bypassed slot_get, so we muste handle slot creation if
-          // dependency tracking is on.
-          if (this_.dependencies_log_get())
-          {
-            val = tgt->slot_get(s).unsafe_cast<object::Slot>()->value(tgt);
-          }
+          val = tgt->slot_get(s).unsafe_cast<object::Slot>()->value(tgt);
         }
-        return call_msg(this_, tgt, val, s, e->arguments_get(),
-        e->location_get());
       }
+      return val;
+    }
+
+    // Accept to call methods on void only if void itself is holding
+    // the method.
+    if (tgt == object::void_class
+        && !tgt->local_slot_get(s))
+      runner::raise_unexpected_void_error();
+    rObject routine;
+    // slot_get also registers the dependencies, in which case the
+    // cache must not be used.
+    if (!job.dependencies_log_get())
+    {
+      object::Object::location_type loc =
+        e->cache_get().slot_locate(tgt.get(), s, true);
+      if (!loc.first)
+        runner::raise_lookup_error(s, tgt);
+      routine = loc.second;
     }
     else
+      routine = tgt->slot_get(s);
+    static ast::exps_type* empty_args = new ast::exps_type();
+    if (object::rSlot sl = routine->as<object::Slot>())
     {
-      return call_msg(this_,
-        tgt, e->name_get(),
-        e->arguments_get(),
-        e->location_get());
+      if (sl->hasLocalSlot(SYMBOL(autoEval)) && !args)
+        args = empty_args;
+      job.state.call_stack_get() << std::make_pair(s, e->location_get());
+      FINALLY((( runner::Job&, job)),
+        job.state.call_stack_get().pop_back());
+      routine = sl->value(tgt);
     }
+    return routine;
+  }
+
+  LIBPORT_SPEED_ALWAYS_INLINE rObject
+  Visitor::visit(const ast::Call* e)
+  {
+    // The invoked slot (probably a function).
+    const ast::rConstExp& ast_tgt = e->target_get();
+    rObject tgt = ast(this_, ast_tgt.get());
+    bool implicit = e->target_implicit();
+    // FIXME: this sucks, but since a=b is desugared into updateSlot, no
+    // way to make the difference.
+    if (implicit && e->name_get() == SYMBOL(updateSlot))
+    {
+      // Replace current target ('updateSlot') with first argument
+      // of updateSlot call.
+      object::objects_type args;
+      strict_args(this_, args, *e->arguments_get());
+      if (args.size() != 2)
+        runner::raise_arity_error(2, args.size());
+      object::rString rs = args[0]->as<object::String>();
+      if (!rs)
+        runner::raise_argument_type_error(1, args[0], object::String::proto);
+      libport::Symbol s(rs->value_get());
+      object::Object::location_type loc;
+      loc = cached_slot_locate(this_, e, tgt, s, false);
+      if (!loc.first) // Try import stacks, throw if not found
+        loc = import_stack_lookup(this_.state, s, tgt, false);
+      if (!loc.first) // Try this, with fallback
+        loc = cached_slot_locate(this_, e, tgt, s, true);
+      if (!loc.first)
+        runner::raise_lookup_error(s, tgt);
+      tgt->slot_update_with_cow(s, args[1], true, loc);
+      return args[1];
+    }
+
+    if (!implicit)
+      if (object::Float* f = tgt->as<object::Float>().get())
+        if (rObject res = unboxed_call(this_, e, f))
+          return res;
+    const ast::exps_type* args;
+    rObject routine = call_routine(this_, e, tgt, args);
+    return call_msg(this_, tgt, routine, e->name_get(), args,
+                    e->location_get());
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE rObject
@@ -680,8 +866,7 @@ namespace eval
   LIBPORT_SPEED_ALWAYS_INLINE rObject
   Visitor::visit(const ast::Local* e)
   {
-    rSlot slot = this_.state.rget(e);
-    rObject value = slot->value();
+    rObject value = this_.state.get(e);
 
     aver(value, "Local variable read before being set");
 
@@ -896,6 +1081,8 @@ namespace eval
       );
 
     this_.state.create_scope_tag();
+    if (engine == engine_bytecode)
+      return bytecode(this_, e);
     return ast(this_, e->body_get().get());
   }
 
@@ -1190,6 +1377,31 @@ static rObject ast_call(Job& job, const ast::Ast* e)
 
 
 
+  // The flower left only the jumps that stay in the current job, see
+  // eval/jump.hh.
+  LIBPORT_SPEED_ALWAYS_INLINE rObject
+  Visitor::visit(const ast::Break*)
+  {
+    throw BreakException();
+  }
+
+
+  LIBPORT_SPEED_ALWAYS_INLINE rObject
+  Visitor::visit(const ast::Continue*)
+  {
+    throw ContinueException();
+  }
+
+
+  LIBPORT_SPEED_ALWAYS_INLINE rObject
+  Visitor::visit(const ast::Return* e)
+  {
+    throw ReturnException(e->value_get()
+                          ? ast(this_, e->value_get().get())
+                          : object::void_class);
+  }
+
+
   /// FIXME: There is a lot in common with Nary, factor.
   LIBPORT_SPEED_ALWAYS_INLINE rObject
   Visitor::visit(const ast::While* e)
@@ -1222,9 +1434,18 @@ static rObject ast_call(Job& job, const ast::Ast* e)
           subrunner->start_job();
         }
         else
-          visit(e->body_get());
+          try
+          {
+            visit(e->body_get());
+          }
+          catch (const ContinueException&)
+          {
+          }
       }
     }
+    catch (const BreakException&)
+    {
+    }
     catch (const sched::ChildException& ce)
     {
       ce.rethrow_child_exception();
@@ -1302,8 +1523,10 @@ namespace ast
 
   // FIXME: Move to AST_FOR_EACH_NODE.
   DEFINE(And);
+  DEFINE(Break);
   DEFINE(Call);
   DEFINE(CallMsg);
+  DEFINE(Continue);
   DEFINE(Dictionary);
   DEFINE(Do);
   DEFINE(Event);
@@ -1320,6 +1543,7 @@ namespace ast
   DEFINE(Pipe);
   DEFINE(Property);
   DEFINE(PropertyWrite);
+  DEFINE(Return);
   DEFINE(Routine);
   DEFINE(Scope);
   DEFINE(Stmt);
@@ -1343,10 +1567,8 @@ namespace ast
   INVALID(Assignment);
   INVALID(At);
   INVALID(Binding);
-  INVALID(Break);
   INVALID(Catch);
   INVALID(Class);
-  INVALID(Continue);
   INVALID(Declaration);
   INVALID(Decrementation);
   INVALID(Emit);
@@ -1359,7 +1581,6 @@ namespace ast
   INVALID(MetaId);
   INVALID(MetaLValue);
   INVALID(OpAssignment);
-  INVALID(Return);
   INVALID(Subscript);
   INVALID(Unscope);
 
@@ -0,0 +1,529 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file eval/bytecode.cc
+ ** \brief Implementation of eval::Bytecode.
+ */
+
+#include <libport/cassert>
+#include <libport/compiler.hh>
+#include <libport/finally.hh>
+#include <libport/foreach.hh>
+
+#include <ast/all.hh>
+
+#include <urbi/object/float.hh>
+#include <urbi/object/global.hh>
+#include <urbi/object/string.hh>
+#include <urbi/object/symbols.hh>
+#include <urbi/object/tag.hh>
+#include <urbi/runner/raise.hh>
+
+#include <object/code.hh>
+
+#include <eval/ast.hh>
+#include <eval/bytecode.hh>
+#include <eval/call.hh>
+#include <eval/jump.hh>
+
+#include <runner/job.hh>
+
+/// Whether the interpreter dispatches with computed gotos rather than
+/// with a switch.
+#if defined __GNUC__
+# define BYTECODE_THREADED 1
+#else
+# define BYTECODE_THREADED 0
+#endif
+
+namespace eval
+{
+  /*----------.
+  | Engines.  |
+  `----------*/
+
+  engine_type engine = engine_ast;
+
+  bool
+  engine_set(const std::string& name)
+  {
+    if (name == "ast")
+      engine = engine_ast;
+    else if (name == "bytecode")
+      engine = engine_bytecode;
+    else
+      return false;
+    return true;
+  }
+
+  const char*
+  engine_name()
+  {
+    return engine == engine_bytecode ? "bytecode" : "ast";
+  }
+
+
+  /*--------------.
+  | Compilation.  |
+  `--------------*/
+
+  Bytecode::Bytecode(const ast::Exp* body)
+    : body_(body)
+  {
+    compile(body);
+    emit(op_return);
+  }
+
+  const ast::Exp*
+  Bytecode::body_get() const
+  {
+    return body_;
+  }
+
+  unsigned
+  Bytecode::emit(opcode op, const ast::Ast* node, unsigned arg)
+  {
+    code_.push_back(Instruction(op, node, arg));
+    return code_.size() - 1;
+  }
+
+  void
+  Bytecode::patch(unsigned at)
+  {
+    code_[at].arg = code_.size();
+  }
+
+  /// Whether \a e is a statement run in background.
+  static bool
+  is_comma(const ast::Exp* e)
+  {
+    const ast::Stmt* s = dynamic_cast<const ast::Stmt*>(e);
+    return s && s->flavor_get() == ast::flavor_comma;
+  }
+
+  void
+  Bytecode::compile(const ast::Exp* e)
+  {
+    if (const ast::Stmt* s = dynamic_cast<const ast::Stmt*>(e))
+      compile(s->expression_get().get());
+
+    else if (const ast::Nary* n = dynamic_cast<const ast::Nary*>(e))
+    {
+      // Background statements need the children collection of the
+      // AST evaluator.
+      foreach (const ast::rConstExp& c, n->children_get())
+        if (is_comma(c.get()))
+          return (void) emit(op_eval, e);
+
+      const ast::exps_type& exps = n->children_get();
+      if (exps.empty())
+        emit(op_void);
+      else if (exps.size() == 1)
+        compile(exps.front().get());
+      else
+      {
+        bool first = true;
+        foreach (const ast::rConstExp& c, exps)
+        {
+          if (!first)
+          {
+            emit(op_pop);
+            emit(op_yield);
+          }
+          first = false;
+          compile(c.get());
+        }
+        emit(op_nary_end);
+      }
+    }
+
+    else if (const ast::Pipe* p = dynamic_cast<const ast::Pipe*>(e))
+    {
+      if (p->children_get().empty())
+        emit(op_void);
+      bool first = true;
+      foreach (const ast::rConstExp& c, p->children_get())
+      {
+        if (!first)
+          emit(op_pop);
+        first = false;
+        compile(c.get());
+      }
+    }
+
+    else if (dynamic_cast<const ast::Float*>(e))
+      emit(op_float, e);
+    else if (dynamic_cast<const ast::String*>(e))
+      emit(op_string, e);
+    else if (dynamic_cast<const ast::Noop*>(e))
+      emit(op_void);
+    else if (dynamic_cast<const ast::This*>(e)
+             || dynamic_cast<const ast::Implicit*>(e))
+      emit(op_this);
+
+    else if (const ast::Local* l = dynamic_cast<const ast::Local*>(e))
+    {
+      if (l->arguments_get())
+        emit(op_eval, e);
+      else
+        emit(op_load, e);
+    }
+
+    else if (const ast::LocalAssignment* a =
+             dynamic_cast<const ast::LocalAssignment*>(e))
+    {
+      compile(a->value_get().get());
+      emit(op_store, e);
+    }
+
+    else if (const ast::LocalDeclaration* d =
+             dynamic_cast<const ast::LocalDeclaration*>(e))
+    {
+      if (d->is_import_get())
+        emit(op_eval, e);
+      else if (d->value_get())
+      {
+        compile(d->value_get().get());
+        emit(op_def, e, true);
+      }
+      else
+      {
+        emit(op_void);
+        emit(op_def, e, false);
+      }
+    }
+
+    else if (const ast::If* i = dynamic_cast<const ast::If*>(e))
+    {
+      compile(i->test_get().get());
+      unsigned to_else = emit(op_jump_unless, e);
+      emit(op_eval, i->thenclause_get().get());
+      unsigned to_end = emit(op_jump);
+      patch(to_else);
+      emit(op_eval, i->elseclause_get().get());
+      patch(to_end);
+    }
+
+    else if (const ast::While* w = dynamic_cast<const ast::While*>(e))
+    {
+      if (w->flavor_get() == ast::flavor_comma)
+        return (void) emit(op_eval, e);
+      // Yield before every iteration but the first one.
+      unsigned to_test = emit(op_jump);
+      unsigned loop = code_.size();
+      if (w->flavor_get() != ast::flavor_pipe)
+        emit(op_yield);
+      patch(to_test);
+      compile(w->test_get().get());
+      unsigned to_end = emit(op_jump_unless, e);
+      unsigned body = emit(op_loop_body, w->body_get().get());
+      emit(op_pop);
+      emit(op_jump, 0, loop);
+      patch(to_end);
+      patch(body);
+      emit(op_void);
+    }
+
+    else if (const ast::Call* c = dynamic_cast<const ast::Call*>(e))
+    {
+      // Assignments to slots are desugared as calls to updateSlot,
+      // whose lookup differs.
+      if (c->target_implicit() && c->name_get() == SYMBOL(updateSlot))
+        return (void) emit(op_eval, e);
+      compile(c->target_get().get());
+      unsigned prepare = emit(op_call_prepare, e);
+      unsigned count = 0;
+      if (const ast::exps_type* args = c->arguments_get())
+        foreach (const ast::rConstExp& arg, *args)
+        {
+          compile(arg.get());
+          emit(op_call_arg, arg.get());
+          ++count;
+        }
+      emit(op_call_apply, e, count);
+      patch(prepare);
+    }
+
+    else
+      emit(op_eval, e);
+  }
+
+
+  /*------------.
+  | Execution.  |
+  `------------*/
+
+  /// Whether \a routine must be called with its arguments as ASTs,
+  /// i.e., whether the caller must not evaluate them.
+  static inline bool
+  lazy_routine(const rObject& routine)
+  {
+    const object::Code* c = routine->as<object::Code>().get();
+    return c && (!c->ast_get()->strict() || c->ast_get()->uses_call_get());
+  }
+
+  const Bytecode::Instruction*
+  Bytecode::run_call_prepare(Job& job, stack_type& stack,
+                             const Instruction* ip) const
+  {
+    const ast::Call* e = static_cast<const ast::Call*>(ip->node);
+    rObject tgt = stack.back();
+    stack.pop_back();
+    const ast::exps_type* args;
+    rObject routine = call_routine(job, e, tgt, args);
+    if (!args || args != e->arguments_get() || lazy_routine(routine))
+    {
+      // The arguments are not evaluated here: skip their code.
+      stack.push_back(call_msg(job, tgt, routine, e->name_get(), args,
+                               e->location_get()));
+      return &code_[ip->arg];
+    }
+    stack.push_back(tgt);
+    stack.push_back(routine);
+    return ip + 1;
+  }
+
+  void
+  Bytecode::run_call_apply(Job& job, stack_type& stack,
+                           const Instruction* ip) const
+  {
+    const ast::Call* e = static_cast<const ast::Call*>(ip->node);
+    unsigned count = ip->arg;
+    stack_type::iterator first = stack.end() - count - 2;
+    rObject tgt = first[0];
+    rObject routine = first[1];
+
+    // Binary Float operators, computed on the values.
+    if (count == 1
+        && !job.dependencies_log_get() && !job.is_profiling())
+      if (object::Float* lhs = tgt->as<object::Float>().get())
+        if (object::Float* rhs = first[2]->as<object::Float>().get())
+        {
+          object::Float::unboxed_type op =
+            object::Float::unboxed_operator(routine.get());
+          if (op != object::Float::unboxed_none)
+            if (rObject res =
+                object::Float::unboxed_apply(op, lhs->value_get(),
+                                             rhs->value_get()))
+            {
+              stack.erase(first, stack.end());
+              stack.push_back(res);
+              return;
+            }
+        }
+
+    object::objects_type call_args;
+    call_args << tgt;
+    for (unsigned i = 0; i < count; ++i)
+      call_args << first[2 + i];
+    stack.erase(first, stack.end());
+    stack.push_back(call_apply(job, routine.get(), e->name_get(),
+                               call_args, 0, e->location_get()));
+  }
+
+  const Bytecode::Instruction*
+  Bytecode::run_loop_body(Job& job, stack_type& stack,
+                          const Instruction* ip) const
+  {
+    try
+    {
+      stack.push_back(ast(job, ip->node));
+    }
+    catch (const ContinueException&)
+    {
+      stack.push_back(object::void_class);
+    }
+    catch (const BreakException&)
+    {
+      return &code_[ip->arg];
+    }
+    return ip + 1;
+  }
+
+  rObject
+  Bytecode::operator()(Job& job) const
+  {
+    const ast::Ast* previous = job.state.innermost_node_get();
+    FINALLY(((Job&, job))((const ast::Ast*, previous)),
+            job.state.innermost_node_set(previous));
+
+    stack_type stack;
+    const Instruction* ip = &code_[0];
+
+#if BYTECODE_THREADED
+    // Same order as the opcodes.
+    static void* labels[] =
+    {
+      &&L_op_eval,
+      &&L_op_float,
+      &&L_op_string,
+      &&L_op_void,
+      &&L_op_this,
+      &&L_op_load,
+      &&L_op_store,
+      &&L_op_def,
+      &&L_op_pop,
+      &&L_op_yield,
+      &&L_op_jump,
+      &&L_op_jump_unless,
+      &&L_op_nary_end,
+      &&L_op_call_prepare,
+      &&L_op_call_arg,
+      &&L_op_call_apply,
+      &&L_op_loop_body,
+      &&L_op_return,
+    };
+# define DISPATCH() goto *labels[ip->op]
+# define CASE(Op) L_ ## Op:
+    DISPATCH();
+#else
+# define DISPATCH() continue
+# define CASE(Op) case Op:
+    while (true)
+      switch (ip->op)
+      {
+#endif
+#define NEXT()                                  \
+    {                                           \
+      ++ip;                                     \
+      DISPATCH();                               \
+    }
+
+    CASE(op_eval)
+      stack.push_back(ast(job, ip->node));
+      NEXT();
+
+    CASE(op_float)
+      stack.push_back(
+        new object::Float(static_cast<const ast::Float*>(ip->node)
+                          ->value_get()));
+      NEXT();
+
+    CASE(op_string)
+      stack.push_back(
+        new object::String(static_cast<const ast::String*>(ip->node)
+                           ->value_get()));
+      NEXT();
+
+    CASE(op_void)
+      stack.push_back(object::void_class);
+      NEXT();
+
+    CASE(op_this)
+      stack.push_back(job.state.this_get());
+      NEXT();
+
+    CASE(op_load)
+      job.state.innermost_node_set(ip->node);
+      stack.push_back(
+        job.state.get(static_cast<const ast::Local*>(ip->node)));
+      aver(stack.back(), "Local variable read before being set");
+      NEXT();
+
+    CASE(op_store)
+      job.state.innermost_node_set(ip->node);
+      if (stack.back() == object::void_class)
+        runner::raise_unexpected_void_error();
+      job.state.set(static_cast<const ast::LocalAssignment*>(ip->node),
+                    stack.back());
+      NEXT();
+
+    CASE(op_def)
+      job.state.innermost_node_set(ip->node);
+      if (ip->arg && stack.back() == object::void_class)
+        runner::raise_unexpected_void_error();
+      job.state.def(static_cast<const ast::LocalDeclaration*>(ip->node),
+                    stack.back(),
+                    static_cast<const ast::LocalDeclaration*>(ip->node)
+                    ->constant_get());
+      NEXT();
+
+    CASE(op_pop)
+      stack.pop_back();
+      NEXT();
+
+    CASE(op_yield)
+      job.yield();
+      NEXT();
+
+    CASE(op_jump)
+      ip = &code_[ip->arg];
+      DISPATCH();
+
+    CASE(op_jump_unless)
+      job.state.innermost_node_set(ip->node);
+      ip = stack.back()->as_bool() ? ip + 1 : &code_[ip->arg];
+      stack.pop_back();
+      DISPATCH();
+
+    CASE(op_nary_end)
+      // If we get a scope tag, stop the runners tagged with it.
+      if (job.state.scope_tag_get())
+        job.state.scope_tag_get()->stop(job.scheduler_get(),
+                                        object::void_class);
+      NEXT();
+
+    CASE(op_call_prepare)
+      job.state.innermost_node_set(ip->node);
+      ip = run_call_prepare(job, stack, ip);
+      DISPATCH();
+
+    CASE(op_call_arg)
+      job.state.innermost_node_set(ip->node);
+      if (stack.back() == object::void_class)
+        runner::raise_unexpected_void_error();
+      NEXT();
+
+    CASE(op_call_apply)
+      job.state.innermost_node_set(ip->node);
+      run_call_apply(job, stack, ip);
+      NEXT();
+
+    CASE(op_loop_body)
+      ip = run_loop_body(job, stack, ip);
+      DISPATCH();
+
+    CASE(op_return)
+      aver(stack.size() == 1);
+      return stack.back();
+
+#if !BYTECODE_THREADED
+      }
+#endif
+#undef NEXT
+#undef CASE
+#undef DISPATCH
+    unreachable();
+  }
+
+
+  /*--------------.
+  | Entry point.  |
+  `--------------*/
+
+  rObject
+  bytecode(Job& job, const ast::Scope* e)
+  {
+    boost::shared_ptr<Bytecode>& code = e->bytecode_get();
+    if (!code || code->body_get() != e->body_get().get())
+      code.reset(new Bytecode(e->body_get().get()));
+    // Keep the code alive, should the scope be recompiled meanwhile.
+    boost::shared_ptr<Bytecode> keep = code;
+    return (*keep)(job);
+  }
+
+  Action
+  bytecode(ast::rConstScope e)
+  {
+    typedef rObject (*fun_type)(Job& job, const ast::Scope* e);
+    return boost::bind((fun_type) &bytecode, _1, e);
+  }
+} // namespace eval
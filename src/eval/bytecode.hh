@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file eval/bytecode.hh
+ ** \brief Definition of eval::Bytecode.
+ */
+
+#ifndef EVAL_BYTECODE_HH
+# define EVAL_BYTECODE_HH
+
+# include <string>
+# include <vector>
+
+# include <ast/fwd.hh>
+# include <eval/action.hh>
+
+namespace eval
+{
+  /// The evaluation engines.
+  enum engine_type
+  {
+    /// Walk the AST (eval::Visitor).
+    engine_ast,
+    /// Compile the bodies of the scopes to bytecode and run it.
+    engine_bytecode
+  };
+
+  /// The engine used to evaluate the scopes.
+  extern engine_type engine;
+
+  /// Select the engine from its name, "ast" or "bytecode".
+  /// \return whether \a name is valid.
+  bool engine_set(const std::string& name);
+
+  /// The name of the current engine.
+  const char* engine_name();
+
+  /// A compiled expression, the body of a scope.
+  ///
+  /// The code is run on a value stack.  Local variables, literals,
+  /// conditionals, loops, sequences and calls are compiled; any other
+  /// node is evaluated by the AST evaluator, through an Eval
+  /// instruction.  Nested scopes are such nodes, so that the scope
+  /// handling (scope tags, imports...) is shared with the AST engine,
+  /// and their bodies are compiled on their own.
+  ///
+  /// The code yields where the AST evaluator does: between the
+  /// statements of a sequence and between the iterations of a loop,
+  /// and in the functions it calls.  The instructions keep the node
+  /// they were compiled from, to read its attributes at run time and
+  /// to locate the errors.
+  class Bytecode
+  {
+  public:
+    /// Compile \a body.
+    Bytecode(const ast::Exp* body);
+
+    /// Run the code in \a job.
+    rObject operator()(Job& job) const;
+
+    /// The compiled expression.
+    const ast::Exp* body_get() const;
+
+  private:
+    enum opcode
+    {
+      /// Push the value of the node, evaluated by the AST evaluator.
+      op_eval,
+      /// Push a new Float, String.
+      op_float,
+      op_string,
+      /// Push void, this.
+      op_void,
+      op_this,
+      /// Push the value of a local variable.
+      op_load,
+      /// Store the top of stack in a local variable, declare one.
+      op_store,
+      op_def,
+      /// Discard the top of stack.
+      op_pop,
+      /// Let other jobs run.
+      op_yield,
+      /// Jump to arg, unconditionally, if the popped value is false.
+      op_jump,
+      op_jump_unless,
+      /// Stop the jobs of the scope tag, at the end of a sequence.
+      op_nary_end,
+      /// Replace the target of a call by the routine and the target,
+      /// or, if the arguments are not evaluated by the caller, by the
+      /// result of the call and jump to arg.
+      op_call_prepare,
+      /// Check the argument on top of the stack.
+      op_call_arg,
+      /// Call the routine with the arg arguments on the stack.
+      op_call_apply,
+      /// Push the value of the body of a loop, or jump to arg on
+      /// `break'.
+      op_loop_body,
+      /// End of the code.
+      op_return
+    };
+
+    struct Instruction
+    {
+      Instruction(opcode o, const ast::Ast* n = 0, unsigned a = 0)
+        : op(o), node(n), arg(a)
+      {}
+      opcode op;
+      const ast::Ast* node;
+      unsigned arg;
+    };
+    typedef std::vector<Instruction> code_type;
+    typedef std::vector<rObject> stack_type;
+
+    /// Compile \a e, whose value is pushed on the stack.
+    void compile(const ast::Exp* e);
+    /// Append an instruction, return its index.
+    unsigned emit(opcode op, const ast::Ast* node = 0, unsigned arg = 0);
+    /// Set the jump target of the instruction \a at to the end.
+    void patch(unsigned at);
+
+    /// Run the op_call_prepare instruction \a ip.
+    /// \return the next instruction to run.
+    const Instruction* run_call_prepare(Job& job, stack_type& stack,
+                                        const Instruction* ip) const;
+    /// Run the op_call_apply instruction \a ip.
+    void run_call_apply(Job& job, stack_type& stack,
+                        const Instruction* ip) const;
+    /// Run the op_loop_body instruction \a ip.
+    /// \return the next instruction to run.
+    const Instruction* run_loop_body(Job& job, stack_type& stack,
+                                     const Instruction* ip) const;
+
+    const ast::Exp* body_;
+    code_type code_;
+  };
+
+  /// Evaluate the body of \a e with the bytecode engine.
+  rObject bytecode(Job& job, const ast::Scope* e);
+  Action  bytecode(ast::rConstScope e);
+} // namespace eval
+
+#endif // ! EVAL_BYTECODE_HH
@@ -138,6 +138,14 @@ namespace eval
   std::pair<object::Object*, object::rObject>
   import_stack_lookup(const runner::State& state,
     libport::Symbol s, rObject& target, bool throwOnError = true);
+
+  /** The routine invoked by \a e, given its evaluated target.
+  @param target will be set to the correct target if found in imports.
+  @param args   set to the arguments to pass the routine.
+  */
+  rObject
+  call_routine(Job& job, const ::ast::Call* e,
+               rObject& target, const ::ast::exps_type*& args);
 } // namespace eval
 
 # if defined LIBPORT_COMPILATION_MODE_SPEED
@@ -49,6 +49,7 @@
 
 #include <eval/ast.hh>
 #include <eval/call.hh>
+#include <eval/jump.hh>
 
 # if defined _MSC_VER || defined __arm__ || defined __clang__ || defined URBI_NO_VLENGTH_ARRAY
 // Use malloc with CL.
@@ -306,7 +307,7 @@ namespace eval
       ((libport::Symbol, msg))                          \
       ((runner::State::var_frame_type, previous_frame)) \
       ((rLobby, caller_lobby))                          \
-      ((rSlot*, local_stack))                           \
+      ((runner::State::var_local_type*, local_stack))   \
       ((rSlot*, captured_stack))                        \
       ((runner::State::import_captured_type, import_captured))  \
       ((rCode, function))                               \
@@ -388,13 +389,14 @@ namespace eval
     // Push new frames on the stacks
     local += 2;
 # if URBI_DYNAMIC_STACK_VECTOR
-    rSlot local_stack_space[local];
+    runner::State::var_local_type local_stack_space[local];
     rSlot captured_stack_space[captured];
-    rSlot* local_stack = &local_stack_space[0];
+    runner::State::var_local_type* local_stack = &local_stack_space[0];
     rSlot* captured_stack = &captured_stack_space[0];
 #elif URBI_DYNAMIC_STACK_NONE
     // FIXME: What about alloca?
-    rSlot* local_stack = new rSlot[local];
+    runner::State::var_local_type* local_stack =
+      new runner::State::var_local_type[local];
     rSlot* captured_stack = new rSlot[captured];
 #else
 # error "No dynamic stack policy defined."
@@ -509,7 +511,17 @@ namespace eval
 
     // GD_INFO_DEBUG("Execution start");
     job.state.execution_starts(msg);
-    return eval::ast(job, ast->body_get().get());
+    // Closures have no `return' of their own.
+    if (ast->closure_get())
+      return eval::ast(job, ast->body_get().get());
+    try
+    {
+      return eval::ast(job, ast->body_get().get());
+    }
+    catch (const ReturnException& r)
+    {
+      return r.value;
+    }
   }
 
   LIBPORT_SPEED_INLINE
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file eval/jump.hh
+ ** \brief Definition of the native control flow exceptions.
+ */
+
+#ifndef EVAL_JUMP_HH
+# define EVAL_JUMP_HH
+
+# include <urbi/object/fwd.hh>
+
+namespace eval
+{
+  /// The `break', `continue' and `return' that the flower left in the
+  /// AST, because they do not cross a job boundary (see
+  /// flower::Flower), are thrown as C++ exceptions rather than stopping
+  /// a flow control tag.  They are not Urbi exceptions: `try' and
+  /// `catch' ignore them, only `finally' clauses are run.
+
+  /// Raised by `break', caught by the innermost loop.
+  struct BreakException
+  {};
+
+  /// Raised by `continue', caught by the innermost loop.
+  struct ContinueException
+  {};
+
+  /// Raised by `return', caught by the innermost function.
+  struct ReturnException
+  {
+    ReturnException(object::rObject v)
+      : value(v)
+    {}
+    object::rObject value;
+  };
+} // namespace eval
+
+#endif // ! EVAL_JUMP_HH
@@ -11,12 +11,15 @@ dist_libuobject@LIBSFX@_la_SOURCES +=           \
   eval/ast.cc                                   \
   eval/ast.hh                                   \
   eval/ast.hxx                                  \
+  eval/bytecode.cc                              \
+  eval/bytecode.hh                              \
   eval/call.cc                                  \
   eval/call.hh                                  \
   eval/call.hxx                                 \
   eval/exec.hh                                  \
   eval/exec.hxx                                 \
   eval/fwd.hh                                   \
+  eval/jump.hh                                  \
   eval/raise.cc                                 \
   eval/raise.hh                                 \
   eval/send-message.cc                          \
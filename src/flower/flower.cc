@@ -31,6 +31,8 @@ namespace flower
     : in_catch_(false)
     , in_function_(false)
     , in_loop_(false)
+    , loop_native_(false)
+    , function_native_(false)
   {}
 
   void
@@ -39,12 +41,93 @@ namespace flower
     errors_.err(loc, msg, "syntax error");
   }
 
+  void
+  Flower::boundary(Finally& finally)
+  {
+    finally << scoped_set(loop_native_, false)
+            << scoped_set(function_native_, false);
+  }
+
+  void
+  Flower::visit(const ast::And* e)
+  {
+    Finally finally;
+    boundary(finally);
+    super_type::visit(e);
+  }
+
+  void
+  Flower::visit(const ast::At* e)
+  {
+    Finally finally;
+    boundary(finally);
+    super_type::visit(e);
+  }
+
+  // The arguments are possibly lazy, hence run elsewhere.
+  void
+  Flower::visit(const ast::Call* e)
+  {
+    Finally finally;
+    if (e->arguments_get())
+      boundary(finally);
+    super_type::visit(e);
+  }
+
+  void
+  Flower::visit(const ast::Class* e)
+  {
+    Finally finally;
+    boundary(finally);
+    super_type::visit(e);
+  }
+
+  void
+  Flower::visit(const ast::Emit* e)
+  {
+    Finally finally;
+    boundary(finally);
+    super_type::visit(e);
+  }
+
+  void
+  Flower::visit(const ast::Event* e)
+  {
+    Finally finally;
+    boundary(finally);
+    super_type::visit(e);
+  }
+
+  void
+  Flower::visit(const ast::Stmt* e)
+  {
+    Finally finally;
+    if (e->flavor_get() == ast::flavor_comma)
+      boundary(finally);
+    super_type::visit(e);
+  }
+
+  void
+  Flower::visit(const ast::Watch* e)
+  {
+    Finally finally;
+    boundary(finally);
+    super_type::visit(e);
+  }
+
   void
   Flower::visit(const ast::Break* b)
   {
     if (!in_loop_)
       err(b->location_get(), "`break' not within a loop");
 
+    if (loop_native_)
+    {
+      result_ = new ast::Break(b->location_get());
+      result_->original_set(b);
+      return;
+    }
+
     has_break_ = true;
 
     PARAMETRIC_AST(res, "'$loopBreakTag'.stop()");
@@ -58,6 +141,13 @@ namespace flower
     if (!in_loop_)
       err(c->location_get(), "`continue' not within a loop");
 
+    if (loop_native_)
+    {
+      result_ = new ast::Continue(c->location_get());
+      result_->original_set(c);
+      return;
+    }
+
     has_continue_ = true;
 
     PARAMETRIC_AST(res, "'$loopContinueTag'.stop()");
@@ -90,10 +180,14 @@ namespace flower
   void
   Flower::visit(const ast::While* code)
   {
+    // The iterations of a "while," are run by other jobs.
+    bool comma = code->flavor_get() == ast::flavor_comma;
     Finally finally;
     finally << scoped_set(in_loop_, true)
             << scoped_set(has_break_, false)
-            << scoped_set(has_continue_, false);
+            << scoped_set(has_continue_, false)
+            << scoped_set(loop_native_, !comma)
+            << scoped_set(function_native_, function_native_ && !comma);
 
     ast::rExp res = code->body_get()->body_get();
     // FIXME: how come res can be null?
@@ -101,6 +195,8 @@ namespace flower
     if (has_continue_)
       res = cont(res.get());
 
+    // The test is not covered by the loop's native jumps.
+    loop_native_ = false;
     PARAMETRIC_AST(whle, "while (%exp:1) %exp:2");
     res = exp(whle % recurse(code->test_get()) % res);
     res.unchecked_cast<ast::While>()->flavor_set(code->flavor_get());
@@ -135,9 +231,12 @@ namespace flower
   Flower::visit(const ast::Foreach* code)
   {
     Finally finally;
+    // The body is a closure, run by "each".
     finally << scoped_set(in_loop_, true)
             << scoped_set(has_break_, false)
-            << scoped_set(has_continue_, false);
+            << scoped_set(has_continue_, false)
+            << scoped_set(loop_native_, false)
+            << scoped_set(function_native_, false);
 
     ast::rExp target = recurse(code->list_get());
 
@@ -168,6 +267,8 @@ namespace flower
   {
     if (code->closure_get())
     {
+      Finally finally;
+      boundary(finally);
       super_type::visit(code);
       return;
     }
@@ -175,7 +276,9 @@ namespace flower
     Finally finally;
     finally << scoped_set(in_function_, true)
             << scoped_set(has_return_, false)
-            << scoped_set(in_loop_, false);
+            << scoped_set(in_loop_, false)
+            << scoped_set(loop_native_, false)
+            << scoped_set(function_native_, true);
     super_type::visit(code);
     if (has_return_)
     {
@@ -195,6 +298,14 @@ namespace flower
     if (!in_function_)
       err(ret->location_get(), "return: outside a function");
 
+    if (function_native_)
+    {
+      ast::rExp e = ret->value_get();
+      result_ = new ast::Return(ret->location_get(), e ? recurse(e) : e);
+      result_->original_set(ret);
+      return;
+    }
+
     has_return_ = true;
 
     if (ast::rExp e = ret->value_get())
@@ -11,6 +11,8 @@
 #ifndef FLOWER_FLOWER_HH
 # define FLOWER_FLOWER_HH
 
+# include <libport/finally.hh>
+
 # include <ast/analyzer.hh>
 # include <ast/loc.hh>
 
@@ -22,6 +24,12 @@ namespace flower
   /// The following syntactic constructs are eliminated:
   /// - "break", "continue" (which impacts "while" and "foreach")
   /// - "return" (which impacts "function", not "closure").
+  ///
+  /// unless they do not leave the job that runs the loop or the
+  /// function: they are then kept, and evaluated as C++ exceptions (see
+  /// eval/jump.hh).  Background statements and loops, "&", closures
+  /// (including the body of "foreach") and the arguments of calls,
+  /// which may be evaluated by another job, are such boundaries.
   class Flower : public ast::Analyzer
   {
   public:
@@ -31,18 +39,29 @@ namespace flower
     Flower();
 
   protected:
-    CONST_VISITOR_VISIT_NODES((Break)
+    CONST_VISITOR_VISIT_NODES((And)
+			      (At)
+			      (Break)
+			      (Call)
 			      (Catch)
+			      (Class)
 			      (Continue)
+			      (Emit)
+			      (Event)
 			      (Foreach)
 			      (Return)
 			      (Routine)
+			      (Stmt)
 			      (Throw)
 			      (Try)
+			      (Watch)
 			      (While));
 
   private:
     void err(const ast::loc& loc, const std::string& msg);
+    /// Enter a construct which might be run by another job: until
+    /// \a finally is run, jump with tags.
+    void boundary(libport::Finally& finally);
     bool has_break_;
     bool has_continue_;
     bool has_general_catch_;
@@ -50,6 +69,11 @@ namespace flower
     bool in_catch_;
     bool in_function_;
     bool in_loop_;
+    /// Whether "break" and "continue" can jump natively to the
+    /// innermost loop.
+    bool loop_native_;
+    /// Whether "return" can jump natively to the innermost function.
+    bool function_native_;
     unsigned int catch_all_;
   };
 
@@ -8,6 +8,8 @@
  * See the LICENSE file for more information.
  */
 
+#include <boost/bind.hpp>
+
 #include <kernel/connection.hh>
 #include <urbi/kernel/userver.hh>
 
@@ -18,6 +20,14 @@ GD_CATEGORY(Urbi.Connection);
 
 namespace kernel
 {
+  namespace
+  {
+    /// Bound to the buffer given to the socket, keeps it alive until
+    /// it is written.
+    void
+    release(boost::shared_ptr<const std::string>)
+    {}
+  }
 
   Connection::Connection()
     : UConnection(*kernel::urbiserver, Connection::PACKET_SIZE)
@@ -81,4 +91,18 @@ namespace kernel
     return length;
   }
 
+  size_t
+  Connection::effective_send_shared
+    (const boost::shared_ptr<const std::string>& data,
+     size_t offset, size_t length)
+  {
+    // Hand the buffer itself to asio, which gathers it with the rest
+    // of the output: no copy, however many connections send it.  The
+    // socket calls the deleter once it is written.
+    if (!closing_)
+      libport::Socket::send(const_cast<char*>(data->data()) + offset, length,
+                            boost::bind(&release, data));
+    return length;
+  }
+
 }
@@ -36,6 +36,9 @@ namespace kernel
     virtual void endline();
 
     virtual size_t effective_send(const char* buffer, size_t length);
+    virtual size_t
+    effective_send_shared(const boost::shared_ptr<const std::string>& data,
+                          size_t offset, size_t length);
   protected:
     virtual void close_();
   };
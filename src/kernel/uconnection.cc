@@ -15,6 +15,7 @@
 #include <libport/cstring>
 #include <libport/cstdio>
 #include <libport/cassert>
+#include <libport/cstdlib>
 #include <sstream>
 #include <iomanip>
 
@@ -55,8 +56,11 @@ namespace kernel
     , server_(server)
     , lobby_(new object::Lobby(this))
     , send_queue_(new queue_type(1024))
+    , popped_(0)
     , packet_size_(packetSize)
     , blocked_(false)
+    , flush_deferred_(false)
+    , deferred_since_(0)
       // Initial state of the connection: unblocked, not receiving binary.
     , active_(true)
     , interactive_p_(true)
@@ -90,28 +94,104 @@ namespace kernel
                              &kernel::urbiserver->ghost_connection_get()==this));
   }
 
+  namespace
+  {
+    /// The maximum latency of the messages whose flush is deferred.
+    static libport::utime_t
+    send_latency()
+    {
+      static libport::utime_t res =
+        getenv("URBI_SEND_LATENCY")
+        ? strtoll(getenv("URBI_SEND_LATENCY"), 0, 0)
+        : 10000;
+      return res;
+    }
+
+    /// The number of bytes pending above which deferred flushes are
+    /// performed right away.
+    static const size_t send_batch_size = 64 * 1024;
+
+    /// Format \a n in decimal, padded with zeros to 8 digits, as
+    /// "%08d" does, in the buffer ending at \a end.  Return the
+    /// beginning of the result.
+    static char*
+    format_time(char* end, libport::utime_t n)
+    {
+      bool negative = n < 0;
+      unsigned long long u = negative ? -n : n;
+      char* res = end;
+      do
+      {
+        *--res = '0' + u % 10;
+        u /= 10;
+      }
+      while (u);
+      while (end - res < 8 - negative)
+        *--res = '0';
+      if (negative)
+        *--res = '-';
+      return res;
+    }
+  }
+
   void
-  UConnection::send(const char* buf, size_t len, const char* tag, bool flush_p)
+  UConnection::send_header_(const char* tag)
   {
-    if (tag)
+    char buf[64];
+    char* end = buf + 32;
+    char* begin = format_time(end, server_.lastTime() / 1000L);
+    *--begin = '[';
+    size_t len = strlen(tag);
+    if (len)
+      *end++ = ':';
+    if (len <= size_t(buf + sizeof buf - 2 - end))
     {
-      if (*tag)
-        send_queue(libport::format("[%08d:%s] ",
-                                   server_.lastTime() / 1000L, tag));
-      else
-        send_queue(libport::format("[%08d] ",
-                                   server_.lastTime() / 1000L));
+      memcpy(end, tag, len);
+      end += len;
+    }
+    else
+    {
+      // A long tag: queue it on its own.
+      send_queue(begin, end - begin);
+      send_queue(tag, len);
+      begin = end;
     }
+    *end++ = ']';
+    *end++ = ' ';
+    send_queue(begin, end - begin);
+  }
+
+  void
+  UConnection::send(const char* buf, size_t len, const char* tag, bool flush_p)
+  {
+    if (tag)
+      send_header_(tag);
     if (buf)
     {
       send_queue(buf, len);
       UErrorValue res = error_;
       if (flush_p && res != UFAIL)
-        flush();
+        defer_flush();
       error_ = res;
     }
   }
 
+  void
+  UConnection::defer_flush()
+  {
+    if (!send_latency())
+      flush();
+    else if (!flush_deferred_)
+    {
+      flush_deferred_ = true;
+      deferred_since_ = libport::utime();
+    }
+    else if (send_latency() <= libport::utime() - deferred_since_
+             || send_batch_size <= send_queue_->size()
+             || !shared_segments_.empty())
+      flush();
+  }
+
   void
   UConnection::send_queue(const char* buf, size_t len)
   {
@@ -121,43 +201,81 @@ namespace kernel
   }
 
   void
-  UConnection::continue_send()
+  UConnection::send_queue(const boost::shared_ptr<const std::string>& data)
   {
-    if (closing_)
+    if (!closing_ && !data->empty())
     {
-      error_ = UFAIL;
-      return;
+      shared_segment s = { popped_ + send_queue_->size(), data, 0 };
+      shared_segments_.push_back(s);
     }
-    blocked_ = false;	    // continue_send unblocks the connection.
+    error_ = USUCCESS;
+  }
 
-    // nb of bytes to send.
-    size_t toSend = std::min(packet_size_, send_queue_->size());
+  size_t
+  UConnection::effective_send_shared
+    (const boost::shared_ptr<const std::string>& data,
+     size_t offset, size_t length)
+  {
+    return effective_send(data->data() + offset, length);
+  }
 
-    if (!toSend)
+  void
+  UConnection::continue_send()
+  {
+    if (closing_)
     {
-      error_ = USUCCESS;
+      error_ = UFAIL;
       return;
     }
+    blocked_ = false;	    // continue_send unblocks the connection.
 
-    if (const char* popData = send_queue_->peek(toSend))
+    // Send packet_size_ bytes at most, alternating between the bytes
+    // of send_queue_ and the shared segments piled in between.
+    size_t budget = packet_size_;
+    while (budget)
     {
-      int wasSent = effective_send(popData, toSend);
-      bytes_sent_ += wasSent;
-      // FIXME: This can never happen, as effective_send
-      // returns a size_t which cannot be negative.
-      if (wasSent < 0)
+      // The bytes of send_queue_ to send before the next segment.
+      size_t queued =
+        shared_segments_.empty()
+        ? send_queue_->size()
+        : shared_segments_.front().position - popped_;
+      size_t toSend;
+      size_t wasSent;
+      if (queued)
       {
-        error_ = UFAIL;
-        return;
+        toSend = std::min(budget, queued);
+        const char* popData = send_queue_->peek(toSend);
+        if (!popData)
+        {
+          error_ = UFAIL;
+          return;
+        }
+        wasSent = effective_send(popData, toSend);
+        if (wasSent && !send_queue_->pop(wasSent))
+        {
+          error_ = UFAIL;
+          return;
+        }
+        popped_ += wasSent;
       }
-      else if (wasSent == 0 || send_queue_->pop(wasSent))
+      else if (!shared_segments_.empty())
       {
-        error_ = USUCCESS;
-        return;
+        shared_segment& s = shared_segments_.front();
+        toSend = std::min(budget, s.data->size() - s.sent);
+        wasSent = effective_send_shared(s.data, s.sent, toSend);
+        s.sent += wasSent;
+        if (s.sent == s.data->size())
+          shared_segments_.pop_front();
       }
+      else
+        break;
+      bytes_sent_ += wasSent;
+      budget -= wasSent;
+      // The connection is full, wait for the next call.
+      if (wasSent < toSend)
+        break;
     }
-
-    error_ = UFAIL;
+    error_ = USUCCESS;
   }
 
   void
@@ -182,7 +300,7 @@ namespace kernel
   bool
   UConnection::send_queue_empty() const
   {
-    return send_queue_->empty();
+    return send_queue_->empty() && shared_segments_.empty();
   }
 
   bool
@@ -209,6 +327,8 @@ namespace kernel
     GD_FINFO_TRACE("close %s (lobby %s, shell %s shelllobby %s)", this,
                    lobby_get().get(),
                    shell_get().get(), shell_get()->state.lobby_get());
+    // Send what is pending, as it would have been without batching.
+    flush_deferred();
     closing_ = true;
     close_();
     // If the shell is currently executing a closure, its lobby has been
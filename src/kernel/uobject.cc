@@ -9,10 +9,12 @@
  */
 
 #include <cstdarg>
+#include <sstream>
 
 #include <libport/bind.hh>
 #include <libport/lexical-cast.hh>
 #include <libport/foreach.hh>
+#include <libport/format.hh>
 #include <libport/hash.hh>
 #include <libport/lexical-cast.hh>
 #include <libport/synchronizer.hh>
@@ -377,7 +379,8 @@ static std::vector<std::pair<std::string, std::string> > bound_context;
     throw std::runtime_error("Current thread is not main thread")
 #endif
 
-/* Statistics gathering about UObject function call time.
+/* Statistics gathering about UObject function call time, and about the
+ * queues of the threaded callbacks.
  */
 namespace Stats
 {
@@ -387,11 +390,15 @@ namespace Stats
     unsigned min;
     unsigned max;
     unsigned count;
+    /// Whether queue is set, i.e., the callback is threaded.
+    bool threaded;
+    urbi::UGenericCallback::QueueStats queue;
   };
   typedef boost::unordered_map<std::string, Value> Values;
   static Values hash;
   static bool enabled = false;
-  static void add(void*, const std::string& key, libport::utime_t d)
+  static void add(void*, const std::string& key, libport::utime_t d,
+                  const urbi::UGenericCallback* ugc = 0)
   {
     if (!enabled)
       return;
@@ -401,6 +408,8 @@ namespace Stats
       Value& v = hash[key];
       v.sum = v.min = v.max = d;
       v.count = 1;
+      v.threaded = false;
+      i = hash.find(key);
     }
     else
     {
@@ -409,6 +418,12 @@ namespace Stats
       i->second.min = std::min(i->second.min, (unsigned)d);
       i->second.max = std::max(i->second.max, (unsigned)d);
     }
+    // For threaded callbacks, d is only the time to queue the call.
+    if (ugc && !ugc->isSynchronous())
+    {
+      i->second.threaded = true;
+      i->second.queue = ugc->queueStats();
+    }
   }
 
   static void clear(rObject)
@@ -427,6 +442,15 @@ namespace Stats
          << new Float(v.second.min)
          << new Float(v.second.max)
          << new Float(v.second.count);
+      if (v.second.threaded)
+      {
+        const urbi::UGenericCallback::QueueStats& q = v.second.queue;
+        *l << new Float(q.size)
+           << new Float(q.maxSize)
+           << new Float(q.dropped)
+           << new Float(q.started ? q.latency / q.started : 0)
+           << new Float(q.maxLatency);
+      }
       res->set(new object::String(v.first), l);
       /*
       size_t sep = v.first.find_first_of(' ');
@@ -531,6 +555,25 @@ static std::vector<std::string> all_uobjects(rObject)
   return res;
 }
 
+/* Serialize \a msg, a list starting with one of the UEM codes, for
+ * the remotes that read binary messages: "BIN <size> uem" followed
+ * by the serialized UValue.  The remote does not have to parse it.
+ */
+static std::string serialize_message(rObject, rObject msg)
+{
+  urbi::UValue v;
+  uvalue_borrow(v, msg);
+  std::ostringstream o;
+  {
+    libport::serialize::BinaryOSerializer oa(o);
+    oa << v;
+  }
+  const std::string& data = o.str();
+  std::string res = libport::format("BIN %s uem\n", data.size());
+  res.append(data);
+  return res;
+}
+
 /* Setter/getter put in oset/oget, bouncing to UObject notifyChange or
  * notifyAccess function.
  */
@@ -571,7 +614,7 @@ wrap_ucallback_notify(const object::objects_type& ol,
   urbi::impl::KernelUGenericCallbackImpl& impl =
     static_cast<urbi::impl::KernelUGenericCallbackImpl&>  (*ugc->impl_);
   urbi::UList l;
-  l.array << new urbi::UValue();
+  l.append();
 
   l[0].storage = ugc->target;
   libport::utime_t t = libport::utime();
@@ -604,7 +647,7 @@ wrap_ucallback_notify(const object::objects_type& ol,
   if (!isChange)
     ret = slot->output_value_get();
 
-  Stats::add(ol.front().get(), traceName, libport::utime() - t);
+  Stats::add(ol.front().get(), traceName, libport::utime() - t, ugc);
   return ret;
 }}
 
@@ -663,7 +706,7 @@ static rObject wrap_ucallback(const object::objects_type& ol,
 {
   GD_FPUSH_TRACE("Calling bound function %s", message);
   urbi::UList l;
-  l.array.reserve(ol.size() - (withThis?1:0));
+  l.reserve(ol.size() - (withThis?1:0));
   urbi::setCurrentContext(urbi::impl::KernelUContextImpl::instance());
   object::check_arg_count(ol.size() - (withThis?1:0), ugc->nbparam);
   bool first = true;
@@ -674,8 +717,9 @@ static rObject wrap_ucallback(const object::objects_type& ol,
       first = false;
       continue;
     }
-    urbi::UValue v = uvalue_cast(co);
-    l.array << new urbi::UValue(v);
+    // The arguments live in ol until we return: borrow their
+    // binaries.  Threaded calls copy the list before returning.
+    uvalue_borrow(l.append(), co);
   }
   libport::utime_t start = libport::utime();
   urbi::UValue res;
@@ -684,16 +728,21 @@ static rObject wrap_ucallback(const object::objects_type& ol,
     << std::make_pair(&ugc->owner ? ugc->owner.__name : "unknown",
                       ugc->name);
   FINALLY(((bool, first)), bound_context.pop_back();GD_INFO_DUMP("Done"));
+  rObject ret;
   // write_and_unfreeze will delete us if true, we handle it if false
-  bool* async_abort = new bool;
-  *async_abort = false;
+  bool* async_abort = 0;
   try
   {
     // This if is there to optimize the synchronous case.
     if (ugc->isSynchronous())
-      res = ugc->__evalcall(l);
+    {
+      // Convert the result in place, rather than copying it into res.
+      const urbi::UValue& r = ugc->__evalcall(l);
+      ret = object_cast(r);
+    }
     else
     {
+      async_abort = new bool(false);
       /* We are going to make a threaded call that will return a result.
        * But while it runs we ourselve can be interrupted by a tag.stop.
        * Furthermore our shared ptr are not thread safe. So:
@@ -728,7 +777,8 @@ static rObject wrap_ucallback(const object::objects_type& ol,
   }
   catch (const sched::exception&)
   {
-    *async_abort = true;
+    if (async_abort)
+      *async_abort = true;
     throw;
   }
   catch (const std::exception& e)
@@ -746,8 +796,8 @@ static rObject wrap_ucallback(const object::objects_type& ol,
   }
   delete async_abort;
   start = libport::utime() - start;
-  Stats::add(ol.front().get(), message, start);
-  return object_cast(res);
+  Stats::add(ol.front().get(), message, start, ugc);
+  return ret ? ret : object_cast(res);
 }
 
 
@@ -2150,6 +2200,8 @@ namespace urbi
                             object::primitive(&all_uobjects));
       where->slot_set_value(SYMBOL(findUObject),
                             object::primitive(&get_robject));
+      where->slot_set_value(SYMBOL(serializeMessage),
+                            object::primitive(&serialize_message));
       Object->slot_set_value(SYMBOL(uvalueDeserialize), primitive(&uvalue_deserialize));
 
       where->bind(SYMBOL(searchPath),    &uobject_uobjectsPath,
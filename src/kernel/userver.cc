@@ -582,6 +582,7 @@ namespace kernel
     if (!async_jobs_.empty())
       async_jobs_process_();
     work_handle_stopall_();
+    work_flush_connections_();
     afterWork();
     big_kernel_lock_.check();
     return next_time;
@@ -680,6 +681,13 @@ namespace kernel
     stopall = false;
   }
 
+  void
+  UServer::work_flush_connections_()
+  {
+    foreach (UConnection* c, *connections_)
+      c->flush_deferred();
+  }
+
   //! UServer destructor.
   UServer::~UServer()
   {
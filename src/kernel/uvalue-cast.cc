@@ -49,7 +49,11 @@ urbi::UDataType uvalue_type(const object::rObject& o)
   pabort(*o);
 }
 
-urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
+/// Fill \a res, which is void, with \a o.  Unless \a copy, the
+/// binaries refer to the data of the kernel Binaries.
+static void
+uvalue_set(urbi::UValue& res, const object::rObject& o, int recursionLevel,
+           bool copy)
 {
   // Protect ourselve against user errors.
   static int maxRecursionLevel = 0;
@@ -64,9 +68,8 @@ urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
   CAPTURE_GLOBAL(Binary);
   CAPTURE_GLOBAL(UObject);
   CAPTURE_GLOBAL(UVar);
-  urbi::UValue res;
   if (object::rUValue bv = o->as<object::UValue>())
-    res = bv->value_get();
+    res.set(bv->value_get(), copy);
   else if (object::rFloat f = o->as<object::Float>())
     res = f->value_get();
   else if (o == object::true_class)
@@ -82,8 +85,9 @@ urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
     res.type = urbi::DATA_LIST;
     res.list = new urbi::UList;
     object::List::value_type& t = o.cast<object::List>()->value_get();
+    res.list->reserve(t.size());
     foreach (const object::rObject& co, t)
-      res.list->array << new urbi::UValue(uvalue_cast(co));
+      uvalue_set(res.list->append(), co, recursionLevel, copy);
   }
   else if (object::rDictionary s = o->as<object::Dictionary>())
   {
@@ -95,7 +99,7 @@ urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
     {
       // Currently, only strings are valid keys.
       if (const object::rString s = p.first->as<object::String>())
-        r[s->value_get()] = uvalue_cast(p.second);
+        uvalue_set(r[s->value_get()], p.second, recursionLevel, copy);
       else
         // Keep message sync with share/urbi/uobject.u
         // (Dictionary.uvalueSerialize).
@@ -119,7 +123,7 @@ urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
                                       data.size(),
                                       keywords.empty() ? "" : " ",
                                       keywords).c_str(),
-                      0, l, i);
+                      0, l, i, copy);
   }
   else if (is_a(o, UObject))
     res = o->slot_get_value(SYMBOL(__uobjectName))
@@ -138,7 +142,8 @@ urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
   else if (object::rMatrix om = o->as<object::Matrix>())
     res, om->value_get();
   else if (o->slot_has(SYMBOL(uvalueSerialize)))
-    res = uvalue_cast(o->call(SYMBOL(uvalueSerialize)), recursionLevel+1);
+    // The serialized value is a temporary: its binaries must be copied.
+    uvalue_set(res, o->call(SYMBOL(uvalueSerialize)), recursionLevel+1, true);
   else // We could not find how to cast this value
   {
     const object::rString& rs =
@@ -147,9 +152,21 @@ urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
       (0, rs, object::to_urbi(SYMBOL(LT_exportable_SP_object_GT)),
        object::to_urbi(SYMBOL(cast)));
   }
+}
+
+urbi::UValue uvalue_cast(const object::rObject& o, int recursionLevel)
+{
+  urbi::UValue res;
+  uvalue_set(res, o, recursionLevel, true);
   return res;
 }
 
+void uvalue_borrow(urbi::UValue& res, const object::rObject& o)
+{
+  res.clear();
+  uvalue_set(res, o, 0, false);
+}
+
 object::rObject
 object_cast(const urbi::UValue& v)
 {
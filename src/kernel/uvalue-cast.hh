@@ -16,6 +16,12 @@
 
 /// Cast an rObject into UValue.
 urbi::UValue uvalue_cast(const urbi::object::rObject&, int recursionLevel=0);
+/** Cast \a o into \a res, without copying the binaries: they refer to
+ *  the data of the kernel Binaries, possibly in lists and dictionaries.
+ *  \a res is valid as long as \a o lives and is not changed, and its
+ *  binaries must not be modified.  Copy it to keep it longer.
+ */
+void uvalue_borrow(urbi::UValue& res, const urbi::object::rObject& o);
 /// Return the UValue type of an rObject
 urbi::UDataType uvalue_type(const urbi::object::rObject&);
 /// Cast an UValue into an rObject.
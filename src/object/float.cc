@@ -43,6 +43,7 @@ namespace urbi
   namespace object
   {
     rObject Float::limits;
+    rObject Float::unboxed_[Float::unboxed_size];
 
     Float::Float(value_type value)
       : value_(value)
@@ -134,6 +135,23 @@ namespace urbi
       BIND(tan);
       BIND(trunc);
 
+      // Remember the primitives the evaluator may short-circuit.
+#define UNBOXED(Name, Op)                                       \
+      unboxed_[unboxed_ ## Name] = local_slot_get_value(SYMBOL(Op))
+
+      UNBOXED(plus,    PLUS);
+      UNBOXED(minus,   MINUS);
+      UNBOXED(star,    STAR);
+      UNBOXED(slash,   SLASH);
+      UNBOXED(lt,      LT);
+      UNBOXED(lt_eq,   LT_EQ);
+      UNBOXED(gt,      GT);
+      UNBOXED(gt_eq,   GT_EQ);
+      UNBOXED(eq_eq,   EQ_EQ);
+      UNBOXED(bang_eq, BANG_EQ);
+
+#undef UNBOXED
+
       // Hack to avoid proto = 0,
       // proto will redefined after.
       proto = this;
@@ -174,6 +192,30 @@ namespace urbi
       return value_get() < rhs;
     }
 
+    /*--------------------.
+    | Unboxed operators.  |
+    `--------------------*/
+
+    rObject
+    Float::unboxed_apply(unboxed_type op, value_type lhs, value_type rhs)
+    {
+      switch (op)
+      {
+      case unboxed_plus:    return new Float(lhs + rhs);
+      case unboxed_minus:   return new Float(lhs - rhs);
+      case unboxed_star:    return new Float(lhs * rhs);
+      case unboxed_slash:   return rhs ? new Float(lhs / rhs) : 0;
+      case unboxed_lt:      return to_urbi(lhs < rhs);
+      case unboxed_lt_eq:   return to_urbi(lhs <= rhs);
+      case unboxed_gt:      return to_urbi(lhs > rhs);
+      case unboxed_gt_eq:   return to_urbi(lhs >= rhs);
+      case unboxed_eq_eq:   return to_urbi(lhs == rhs);
+      case unboxed_bang_eq: return to_urbi(lhs != rhs);
+      case unboxed_none:    break;
+      }
+      return 0;
+    }
+
     /*--------------.
     | Conversions.  |
     `--------------*/
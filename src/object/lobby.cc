@@ -14,6 +14,7 @@
  */
 
 #include <libport/cassert>
+#include <libport/format.hh>
 
 #include <urbi/kernel/uconnection.hh>
 #include <kernel/ughostconnection.hh>
@@ -61,6 +62,7 @@ namespace urbi
     {
       BIND(send, send, void (Lobby::*)(const std::string&));
       BIND(send, send, void (Lobby::*)(const std::string&, const std::string&));
+      BIND(sendBinary, send_binary);
 
       BIND(binaryMode);
       BINDG(bytesReceived);
@@ -149,7 +151,24 @@ namespace urbi
     Lobby::send(const std::string& data, const std::string& tag)
     {
       REQUIRE_DERIVATIVE_AND_CONNECTION();
-      connection_->send(data + "\n", tag.c_str());
+      connection_->send(data.c_str(), data.size(), tag.c_str(), false);
+      connection_->send("\n", 1);
+    }
+
+    void
+    Lobby::send_binary(const std::string& keywords, rString data,
+                       const std::string& tag)
+    {
+      REQUIRE_DERIVATIVE_AND_CONNECTION();
+      // The buffer is shared by all the connections it is sent to.
+      boost::shared_ptr<const std::string> d = data->shared_get();
+      std::string header = libport::format("BIN %s%s%s\n",
+                                           d->size(),
+                                           keywords.empty() ? "" : " ",
+                                           keywords);
+      connection_->send(header.c_str(), header.size(), tag.c_str(), false);
+      connection_->send_queue(d);
+      connection_->send("\n", 1);
     }
 
     void
@@ -157,7 +176,7 @@ namespace urbi
     {
       REQUIRE_DERIVATIVE_AND_CONNECTION();
       connection_->send_queue(data.c_str(), data.size());
-      connection_->flush();
+      connection_->defer_flush();
     }
 
     void
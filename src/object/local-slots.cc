@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+#include <urbi/object/object.hh>
+
+namespace urbi
+{
+  namespace object
+  {
+    LocalSlots::LocalSlots()
+      : size_(0)
+      , large_(0)
+    {
+    }
+
+    LocalSlots::LocalSlots(const LocalSlots&)
+      : size_(0)
+      , large_(0)
+    {
+    }
+
+    LocalSlots&
+    LocalSlots::operator=(const LocalSlots&)
+    {
+      return *this;
+    }
+
+    LocalSlots::~LocalSlots()
+    {
+      delete large_;
+    }
+  }
+}
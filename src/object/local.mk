@@ -37,7 +37,9 @@ dist_libuobject@LIBSFX@_la_SOURCES +=		\
   object/job.cc					\
   object/list.cc				\
   object/lobby.cc				\
+  object/local-slots.cc				\
   object/location.cc				\
+  object/lookup-cache.cc			\
   object/matrix.cc				\
   object/object-class.cc			\
   object/object-class.hh			\
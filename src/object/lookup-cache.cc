@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file object/lookup-cache.cc
+ ** \brief Implementation of object::LookupCache.
+ */
+
+#include <urbi/object/lookup-cache.hxx>
+
+namespace urbi
+{
+  namespace object
+  {
+    unsigned long LookupCache::hits = 0;
+    unsigned long LookupCache::misses = 0;
+
+    LookupCache::LookupCache()
+      : next_(0)
+    {
+      for (unsigned i = 0; i < size; ++i)
+        entries_[i].receiver = 0;
+    }
+
+    void
+    LookupCache::stats_reset()
+    {
+      hits = 0;
+      misses = 0;
+    }
+
+    LookupCache::location_type
+    LookupCache::miss_(const Object* tgt, libport::Symbol k, bool fallback)
+    {
+      ++misses;
+      Object::lookup_volatile_ = false;
+      location_type res = tgt->slot_locate(k, fallback);
+      // Lookups going through protos exposed to Urbi cannot be
+      // invalidated reliably.
+      if (Object::lookup_volatile_)
+        return res;
+      Entry& e = entries_[next_];
+      next_ = (next_ + 1) % size;
+      e.receiver = tgt;
+      e.name = k;
+      e.fallback = fallback;
+      e.shape_version = tgt->shape_version_;
+      e.protos_version = Object::protos_version_;
+      e.owner = res.first;
+      e.value = res.second.get();
+      return res;
+    }
+  }
+}
@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <vector>
 
 #include <boost/lambda/lambda.hpp>
 
@@ -45,7 +46,11 @@
 #include <eval/send-message.hh>
 #include <eval/call.hh>
 
-#include <urbi/object/centralized-slots.hxx>
+#if URBI_CENTRALIZED_SLOTS
+# include <urbi/object/centralized-slots.hxx>
+#else
+# include <urbi/object/local-slots.hxx>
+#endif
 GD_CATEGORY(Urbi.Object);
 
 
@@ -87,6 +92,8 @@ namespace urbi
       , protos_(0)
       , slots_()
       , lookup_id_(INT_MAX)
+      , shape_version_(++shape_version_counter_)
+      , is_proto_(false)
     {
     }
 
@@ -122,6 +129,9 @@ namespace urbi
       }
       protos_cache_ = protos;
       protos_ = &protos->value_get();
+      // From now on, the protos can be changed from Urbi without
+      // notice, see lookup_volatile_.
+      shape_changed_();
       return protos;
     }
 
@@ -133,6 +143,9 @@ namespace urbi
       protos_cache_ = 0;
       protos_ = 0;
       proto_ = o;
+      if (o)
+        o->is_proto_ = true;
+      shape_changed_();
     }
 
     void
@@ -141,6 +154,8 @@ namespace urbi
       proto_set(0);
       if (l->value_get().empty())
         return;
+      foreach (const rObject& p, l->value_get())
+        p->is_proto_ = true;
       if (l->value_get().size() == 1)
         proto_ = l->value_get().front();
       else
@@ -152,6 +167,9 @@ namespace urbi
     }
 
     static int lookup_id = 0;
+    unsigned long Object::shape_version_counter_ = 0;
+    unsigned long Object::protos_version_ = 0;
+    bool Object::lookup_volatile_ = false;
 
     inline Object::location_type
     Object::slot_locate_(key_type k) const
@@ -169,6 +187,8 @@ namespace urbi
       }
       else if (protos_) // Braces to pacify G++.
       {
+        if (protos_cache_)
+          lookup_volatile_ = true;
         foreach (const rObject& proto, *protos_)
         {
           location_type rec = proto->slot_locate_(k);
@@ -262,7 +282,7 @@ namespace urbi
         // We want to hook changed, so create on-demand slot
         rSlot rs = new Slot(res);
         GD_FINFO_TRACE("Transparent slot creation for %s: %s", k, rs);
-        loc.first->slots_.set(loc.first, k, rs, true);
+        loc.first->slot_overwrite_(k, rs);
         res = rs;
         // no need to hook anything, slot getter will take care of that.
       }
@@ -307,11 +327,19 @@ namespace urbi
         GD_FINFO_DEBUG("Slot redefinition: %s", k);
         runner::raise_urbi_skip(SYMBOL(Redefinition), to_urbi(k));
       }
+      shape_changed_();
       if (!fastHook)
         slotAdded();
       return *this;
     }
 
+    void
+    Object::slot_overwrite_(key_type k, const rObject& v)
+    {
+      slots_.set(this, k, v, true);
+      shape_changed_();
+    }
+
     Object&
     Object::slot_set(key_type key, rObject getter, rObject setter)
     {
@@ -407,10 +435,10 @@ namespace urbi
             // Create a slot with the value in it.
             // This is the ctor taking a rObject as slot value.
             s = new Slot(v);
-            slots_.set(r.first, k, s, true);
+            r.first->slot_overwrite_(k, s);
           }
           else
-            slots_.set(r.first, k, v, true);
+            r.first->slot_overwrite_(k, v);
         }
         else // Slot present, update it.
           s->set(v, this);
@@ -431,10 +459,10 @@ namespace urbi
           if (v->as<Slot>())
           { // We need a slot.
             rSlot slot(new Slot(v));
-            slots_.set(this, k, slot, true);
+            slot_overwrite_(k, slot);
           }
           else
-            slots_.set(this, k, v, true);
+            slot_overwrite_(k, v);
         }
       }
       return v;
@@ -445,14 +473,18 @@ namespace urbi
     | Properties.  |
     `-------------*/
 
+    /// A copy of slots, to iterate while they may change.
+    typedef std::vector<Object::slots_implem::q_slot_type> slots_type;
+
     rDictionary
     Object::properties_get()
     {
+      // Fetching the properties may run user code that changes the
+      // slots, and invalidates the iterators: work on a copy.
+      slots_type slots(slots_.begin(this), slots_.end(this));
       Dictionary::value_type res;
-      for (slots_implem::const_iterator slot = slots_.begin(this);
-           slot != slots_.end(this);
-           ++slot)
-        res[new String(slot->first.second)] = properties_get(slot->first.second);
+      foreach (const slots_implem::q_slot_type& slot, slots)
+        res[new String(slot.first.second)] = properties_get(slot.first.second);
       return new Dictionary(res);
     }
 
@@ -469,14 +501,13 @@ namespace urbi
       }
       Slot& s = *rs;
       Dictionary::value_type res;
-      for (slots_implem::const_iterator slot = slots_.begin(&s);
-           slot != slots_.end(&s);
-           ++slot)
+      slots_type props(slots_.begin(&s), slots_.end(&s));
+      foreach (const slots_implem::q_slot_type& prop, props)
       {
-        if (rSlot rs = slot->second->as<Slot>())
-          res[new String(slot->first.second)] = rs->value(this);
+        if (rSlot rs = prop.second->as<Slot>())
+          res[new String(prop.first.second)] = rs->value(this);
         else
-          res[new String(slot->first.second)] = slot->second;
+          res[new String(prop.first.second)] = prop.second;
       }
       // Add cached slots
       res[new String("constant")] = to_urbi(s.constant_get());
@@ -517,7 +548,7 @@ namespace urbi
       {
         // Create the slot
         rSlot rs(new Slot(val));
-        slots_.set(loc.first, slot, rs, true);
+        loc.first->slot_overwrite_(slot, rs);
         return rs->property_get(prop);
       }
       else if (prop == SYMBOL(rangemin))
@@ -553,7 +584,7 @@ namespace urbi
       if (!rs)
       {
         rs = new Slot(loc.second);
-        slots_.set(this, k, rs, true);
+        slot_overwrite_(k, rs);
       }
       if (rs->property_set(p, value)
           && rs->slot_has(SYMBOL(newPropertyHook)))
@@ -593,7 +624,7 @@ namespace urbi
 
     std::ostream&
     Object::slot_dump(std::ostream& o,
-                      const CentralizedSlots::q_slot_type& s,
+                      const slots_implem::q_slot_type& s,
                       int depth_max) const
     {
       rSlot slot = s.second->as<Slot>();
@@ -604,11 +635,10 @@ namespace urbi
       val->dump(o, depth_max)
         << libport::iendl;
       bool started = false;
-      for (slots_implem::const_iterator slot = slots_.begin(s.second);
-           slot != slots_.end(s.second);
-           ++slot)
+      slots_type props(slots_.begin(s.second), slots_.end(s.second));
+      foreach (const slots_implem::q_slot_type& prop, props)
       {
-        libport::Symbol k = libport::Symbol(slot->first.second);
+        libport::Symbol k = libport::Symbol(prop.first.second);
         if (k == SYMBOL(constant))
           continue;
         if (!started)
@@ -616,10 +646,10 @@ namespace urbi
         else
           o << libport::iendl;
         o << k << " = ";
-        if (rSlot s = slot->second->as<Slot>())
+        if (rSlot s = prop.second->as<Slot>())
           s->value(val)->dump(o, depth_max);
         else
-          slot->second->dump(o, depth_max);
+          prop.second->dump(o, depth_max);
         started = true;
       }
       if (slot)
@@ -701,10 +731,10 @@ namespace urbi
       special_slots_dump(o);
 
       o << "/* Slots */" << libport::iendl;
-      for (slots_implem::const_iterator i = slots_.begin(this);
-           i != slots_.end(this);
-           ++i)
-        slot_dump(o, *i, depth_max);
+      // Dumping runs the getters, which may change the slots.
+      slots_type slots(slots_.begin(this), slots_.end(this));
+      foreach (const slots_implem::q_slot_type& slot, slots)
+        slot_dump(o, slot, depth_max);
 
       o << libport::decindent << '}';
       --current_depth(o);
@@ -762,6 +792,8 @@ namespace urbi
            "referring to a not-yet-initialized class\n"
            "See the stack trace to find the dependency to add in "
            "root_classes_initialize().");
+      p->is_proto_ = true;
+      shape_changed_();
       if (!protos_)
       {
         if (proto_ == p)
@@ -826,7 +858,7 @@ namespace urbi
         return s;
       // Convert it to a slot.
       rSlot s(new Slot(r.second));
-      slots_.set(r.first, name, s, true);
+      r.first->slot_overwrite_(name, s);
       return s;
     }
 
@@ -865,7 +897,7 @@ namespace urbi
         if (!s->as<Slot>())
         {
           rSlot rs(new Slot(s));
-          slots_.set(this, name, rs, true);
+          slot_overwrite_(name, rs);
           return rs;
         }
         else
@@ -973,7 +1005,7 @@ namespace urbi
         return s;
       // Convert it to a slot.
       rSlot s(new Slot(loc.second));
-      slots_.set(loc.first, k, s, true);
+      loc.first->slot_overwrite_(k, s);
       return s;
     }
 
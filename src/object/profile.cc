@@ -206,13 +206,14 @@ namespace urbi
     {
       i.checkpoint = libport::utime();
       i.function_current = current;
-      if (!functions_profile_[current])
+      rFunctionProfile& p = functions_profile_[current];
+      if (!p)
       {
-        functions_profile_[current] = new FunctionProfile;
-        functions_profile_[current]->name_ = name;
+        p = new FunctionProfile;
+        p->name_ = name;
       }
       if (count)
-        ++functions_profile_[current]->calls_;
+        ++p->calls_;
     }
 
     void
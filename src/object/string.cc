@@ -51,6 +51,7 @@ namespace urbi
 
     String::String(rString model)
       : content_(model->content_)
+      , shared_(model->shared_)
     {
       proto_add(proto);
     }
@@ -176,23 +177,50 @@ namespace urbi
       int i = Float::to_int_type(idx, "invalid index: %s");
       // When working on end, prefer size() to 0.
       if (i < 0 || (large && i == 0))
-        i += content_.size();
+        i += size();
       if (i < 0
-          || ((large ? 1 : 0) + content_.size()) < static_cast<size_type>(i))
+          || ((large ? 1 : 0) + size()) < static_cast<size_type>(i))
         FRAISE("invalid index: %s", idx);
       return static_cast<size_type>(i);
     }
 
     const String::value_type& String::value_get() const
     {
-      return content_;
+      return shared_ ? *shared_ : content_;
     }
 
     String::value_type& String::value_get()
     {
+      unshare_();
       return content_;
     }
 
+    boost::shared_ptr<const String::value_type>
+    String::shared_get() const
+    {
+      // Move the content into the shared buffer, no copy.
+      if (!shared_)
+      {
+        shared_.reset(new value_type);
+        std::swap(*shared_, content_);
+      }
+      return shared_;
+    }
+
+    void
+    String::unshare_()
+    {
+      if (!shared_)
+        return;
+      // Take the buffer back if nobody else holds it, otherwise leave
+      // it to its holders.
+      if (shared_.unique())
+        std::swap(content_, *shared_);
+      else
+        content_ = *shared_;
+      shared_.reset();
+    }
+
     bool
     String::operator<=(const value_type& rhs) const
     {
@@ -210,19 +238,19 @@ namespace urbi
     String::value_type
     String::plus(rObject rhs) const
     {
-      return content_ + rhs->as_string();
+      return value_get() + rhs->as_string();
     }
 
     String::size_type
     String::size() const
     {
-      return content_.size();
+      return value_get().size();
     }
 
     bool
     String::empty() const
     {
-      return content_.empty();
+      return value_get().empty();
     }
 
     bool
@@ -236,7 +264,7 @@ namespace urbi
     {
       try
       {
-        return libport::as_ufloat(content_);
+        return libport::as_ufloat(value_get());
       }
       catch (const boost::bad_lexical_cast&)
       {
@@ -249,14 +277,14 @@ namespace urbi
     {
       // See https://svn.boost.org/trac/boost/ticket/6264, we cannot
       // use string_cast here since Boost 1.48.
-      return libport::format("\"%s\"", libport::escape(content_, '"'));
+      return libport::format("\"%s\"", libport::escape(value_get(), '"'));
     }
 
 #if !defined COMPILATION_MODE_SPACE
     String::value_type
     String::format(rFormatInfo finfo) const
     {
-      value_type res(!finfo->uppercase_get() ? content_
+      value_type res(!finfo->uppercase_get() ? value_get()
                      : finfo->uppercase_get() > 0 ? to_upper()
                      : to_lower());
 
@@ -280,7 +308,7 @@ namespace urbi
     String::value_type
     String::as_string() const
     {
-      return content_;
+      return value_get();
     }
 
     rString
@@ -292,6 +320,7 @@ namespace urbi
     const String::value_type&
     String::set(const value_type& rhs)
     {
+      shared_.reset();
       return content_ = rhs;
     }
 
@@ -345,7 +374,7 @@ namespace urbi
       foreach (const rObject& o, os)
       {
         if (!first)
-          res += content_;
+          res += value_get();
         first = false;
         res += o->as_string();
       }
@@ -386,7 +415,7 @@ namespace urbi
       // characters.
       if (libport::has(sep, ""))
       {
-        foreach (char c, content_)
+        foreach (char c, value_get())
           res << value_type(1, c);
         return res;
       }
@@ -394,11 +423,11 @@ namespace urbi
       {
         size_t start = 0;
         value_type delim;
-        for (size_t end = find_first(sep, content_, start, delim);
+        for (size_t end = find_first(sep, value_get(), start, delim);
              end != value_type::npos && limit;
-             end = find_first(sep, content_, start, delim), --limit)
+             end = find_first(sep, value_get(), start, delim), --limit)
         {
-          value_type sub = content_.substr(start, end - start);
+          value_type sub = value_get().substr(start, end - start);
           if (keep_empty || !sub.empty())
             res << sub;
           if (keep_delim)
@@ -407,7 +436,7 @@ namespace urbi
         }
 
         if (start < size() || keep_empty)
-          res << content_.substr(start);
+          res << value_get().substr(start);
       }
       return res;
     }
@@ -456,16 +485,17 @@ namespace urbi
     String::value_type String::sub(ufloat from, ufloat to) const
     {
       check_bounds(from, to);
-      return content_.substr(index(from), index(to, true) - index(from));
+      return value_get().substr(index(from), index(to, true) - index(from));
     }
 
     String::value_type
     String::sub_eq(ufloat from, ufloat to, const value_type& v)
     {
       check_bounds(from, to);
-      content_ = (content_.substr(0, index(from))
-                  + v
-                  + content_.substr(index(to, true), value_type::npos));
+      value_type& s = value_get();
+      s = (s.substr(0, index(from))
+           + v
+           + s.substr(index(to, true), value_type::npos));
       return v;
     }
 
@@ -489,7 +519,7 @@ namespace urbi
 #define IS(Spec)                                \
     bool String::is_ ## Spec() const            \
     {                                           \
-      foreach (char c, content_)                \
+      foreach (char c, value_get())                \
         if (!is ## Spec(c))                     \
           return false;                         \
       return true;                              \
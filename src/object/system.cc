@@ -36,6 +36,7 @@
 #include <urbi/object/float.hh>
 #include <urbi/object/global.hh>
 #include <urbi/object/list.hh>
+#include <urbi/object/lookup-cache.hh>
 #include <urbi/object/object.hh>
 #include <urbi/object/path.hh>
 #include <object/profile.hh>
@@ -44,7 +45,8 @@
 #include <object/system.hh>
 #include <urbi/object/tag.hh>
 #include <urbi/object/job.hh>
-#include <parser/transform.hh>
+#include <parser/eval-cache.hh>
+#include <parser/image.hh>
 #include <runner/exception.hh>
 #include <runner/job.hh>
 #include <runner/shell.hh>
@@ -84,11 +86,10 @@ namespace urbi
     {
 
       static rObject
-      execute_parsed(parser::parse_result_type p, rObject self)
+      execute_ast(ast::rConstAst ast, rObject self)
       {
         // We execute as if the code was in the current context.
         // But said code may contain import directives.
-        ast::rConstAst ast = parser::transform(ast::rConstExp(p));
         runner::Job& run = runner();
         runner::State& state = run.state;
         if (!state.has_import_stack)
@@ -117,6 +118,21 @@ namespace urbi
                             self ? self : rObject(run.state.lobby_get()));
       }
 
+      /// A file loaded while the load report is enabled.
+      struct loaded_file
+      {
+        std::string name;
+        /// Whether its image was used.
+        bool image;
+        /// The time spent parsing it (or reading its image), and
+        /// evaluating it, including the files it loads.
+        libport::utime_t load;
+        libport::utime_t eval;
+      };
+
+      /// The files loaded since load_report_start, if enabled.
+      static std::vector<loaded_file>* load_report_ = 0;
+      static libport::utime_t load_report_start_;
     }
 
     rObject system_class;
@@ -185,7 +201,7 @@ namespace urbi
     eval(const std::string& code, rObject self)
       try
       {
-        return execute_parsed(parser::parse(code, ast::loc()), self);
+        return execute_ast(parser::eval_cache_load(code), self);
       }
       catch (const runner::Exception& e)
       {
@@ -281,7 +297,24 @@ namespace urbi
 #endif
       try
       {
-        return execute_parsed(parser::parse_file(filename), self);
+        // Use the images of the library, i.e., the files loaded while
+        // the kernel starts, and the system files.
+        bool use_image =
+          ::kernel::urbiserver->mode_get() == ::kernel::UServer::mode_kernel
+          || libport::has(system_files_get(), libport::Symbol(filename));
+        libport::utime_t start = libport::utime();
+        bool from_image;
+        ast::rConstAst ast =
+          parser::image_load(filename, use_image, &from_image);
+        libport::utime_t loaded = libport::utime();
+        rObject res = execute_ast(ast, self);
+        if (load_report_)
+        {
+          loaded_file f = { filename, from_image,
+                            loaded - start, libport::utime() - loaded };
+          *load_report_ << f;
+        }
+        return res;
       }
       catch (const runner::Exception& e)
       {
@@ -296,6 +329,36 @@ namespace urbi
       return system_loadFile(self, filename, 0);
     }
 
+    void
+    load_report_start()
+    {
+      if (!load_report_)
+        load_report_ = new std::vector<loaded_file>;
+      load_report_start_ = libport::utime();
+    }
+
+    void
+    load_report(std::ostream& o)
+    {
+      if (!load_report_)
+        return;
+      o << "startup report (ms; evaluations include the nested loads):"
+        << std::endl
+        << libport::format("%10s %10s  %-6s %s",
+                           "load", "eval", "from", "file")
+        << std::endl;
+      foreach (const loaded_file& f, *load_report_)
+        o << libport::format("%10.3f %10.3f  %-6s %s",
+                             f.load / 1000., f.eval / 1000.,
+                             f.image ? "image" : "source", f.name)
+          << std::endl;
+      o << libport::format("%10.3f total",
+                           (libport::utime() - load_report_start_) / 1000.)
+        << std::endl;
+      delete load_report_;
+      load_report_ = 0;
+    }
+
     static float
     system_cycle()
     {
@@ -332,6 +395,11 @@ namespace urbi
       ADDSTAT(StdDev, standard_deviation, 1e6);
       ADDSTAT(Variance, variance, 1e3);
 #undef ADDSTAT
+      res[new String("lookupCacheHits")] = new Float(LookupCache::hits);
+      res[new String("lookupCacheMisses")] = new Float(LookupCache::misses);
+      res[new String("evalCacheHits")] = new Float(parser::eval_cache_hits);
+      res[new String("evalCacheMisses")] =
+        new Float(parser::eval_cache_misses);
       return res;
     }
 
@@ -339,6 +407,8 @@ namespace urbi
     system_resetStats()
     {
       ::kernel::scheduler().stats_reset();
+      LookupCache::stats_reset();
+      parser::eval_cache_stats_reset();
     }
 
     static void
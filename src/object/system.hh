@@ -16,6 +16,7 @@
 #ifndef OBJECT_SYSTEM_HH
 # define OBJECT_SYSTEM_HH
 
+# include <iosfwd>
 # include <set>
 
 # include <ast/loc.hh>
@@ -52,6 +53,11 @@ namespace urbi
 
     /// Run actions registered with URBI_INITIALIZATION_REGISTER.
     void initializations_run();
+
+    /// Start recording the time spent in the loaded files.
+    void load_report_start();
+    /// Report the recorded times on \a o, and stop recording.
+    void load_report(std::ostream& o);
   }; // namespace object
 }
 
@@ -0,0 +1,519 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file parser/eval-cache.cc
+ ** \brief Implementation of parser::eval_cache_load.
+ */
+
+#include <cctype>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/erase.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <libport/cstdlib>
+#include <libport/debug.hh>
+#include <libport/finally.hh>
+#include <libport/foreach.hh>
+#include <libport/format.hh>
+#include <libport/ufloat.hh>
+
+#include <ast/all.hh>
+#include <ast/cloner.hh>
+#include <ast/loc.hh>
+
+#include <parser/eval-cache.hh>
+#include <parser/parse.hh>
+#include <parser/transform.hh>
+#include <parser/uparser.hh>
+
+#include <runner/exception.hh>
+
+GD_CATEGORY(Urbi.Parser);
+
+namespace parser
+{
+  unsigned long eval_cache_hits = 0;
+  unsigned long eval_cache_misses = 0;
+
+  void
+  eval_cache_stats_reset()
+  {
+    eval_cache_hits = 0;
+    eval_cache_misses = 0;
+  }
+
+  namespace
+  {
+    using libport::ufloat;
+
+    /// Code longer than this is not cached: it is usually the
+    /// contents of a file, evaluated once.
+    static const size_t max_code_size = 16 * 1024;
+
+    /// The number of ASTs kept by the cache.
+    static size_t
+    capacity()
+    {
+      static size_t res =
+        getenv("URBI_EVAL_CACHE")
+        ? strtoul(getenv("URBI_EVAL_CACHE"), 0, 0)
+        : 256;
+      return res;
+    }
+
+    /// Whether the literals are lifted out of the code.
+    static bool
+    parametric()
+    {
+      static bool res = !getenv("URBI_EVAL_CACHE_PARAMETRIC")
+        || std::string(getenv("URBI_EVAL_CACHE_PARAMETRIC")) != "0";
+      return res;
+    }
+
+    /// Parse and transform \a code, as a top-level statement if
+    /// \a toplevel.
+    static ast::rConstAst
+    build(const std::string& code, bool toplevel)
+    {
+      ast::loc loc;
+      UParser p(code, &loc);
+      p.oneshot_set(!toplevel);
+      return transform(ast::rConstExp(p.parse()));
+    }
+
+
+    /*------------.
+    | Templates.  |
+    `------------*/
+
+    /// A numeric literal lifted out of some code.
+    struct literal
+    {
+      /// Its value.
+      ufloat value;
+      /// The position of the end of its sentinel in the template.
+      unsigned line;
+      unsigned column;
+      /// Its length, minus the length of its sentinel.
+      int delta;
+    };
+    typedef std::vector<literal> literals_type;
+
+    /// The values of the sentinels that replace the literals in the
+    /// templates: the k-th literal is replaced by "<k+1>e-300", a
+    /// value that cannot be the result of a transformation.
+    static std::vector<ufloat> sentinels_;
+
+    /// The text of the \a k-th sentinel.
+    static std::string
+    sentinel(size_t k)
+    {
+      std::string res = libport::format("%se-300", k + 1);
+      if (sentinels_.size() == k)
+        sentinels_.push_back(boost::lexical_cast<ufloat>(res));
+      return res;
+    }
+
+    /// The index of the sentinel \a v, or -1 if it is not one.
+    static int
+    sentinel_index(ufloat v)
+    {
+      if (!(0 < v && v < 1e-200))
+        return -1;
+      size_t k = size_t(v * 1e300 + 0.5);
+      if (!k || sentinels_.size() < k || sentinels_[k - 1] != v)
+        return -1;
+      return k - 1;
+    }
+
+    static inline bool
+    is_digit(char c)
+    {
+      return '0' <= c && c <= '9';
+    }
+
+    static inline bool
+    is_id(char c)
+    {
+      return isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    /// The length of the NATURAL at the beginning of \a s, or 0.
+    static size_t
+    natural(const char* s)
+    {
+      size_t res = 0;
+      if (is_digit(*s))
+        for (size_t i = 0; is_digit(s[i]) || s[i] == '_'; ++i)
+          if (is_digit(s[i]))
+            res = i + 1;
+      return res;
+    }
+
+    /// The length of the NUMBER at the beginning of \a s, which
+    /// starts with a digit, as matched by the scanner.
+    static size_t
+    number(const char* s)
+    {
+      size_t res = natural(s);
+      if (s[res] == '.')
+        if (size_t n = natural(s + res + 1))
+          res += 1 + n;
+      if (s[res] == 'e' || s[res] == 'E')
+      {
+        size_t sign = s[res + 1] == '+' || s[res + 1] == '-';
+        if (size_t n = natural(s + res + 1 + sign))
+          res += 1 + sign + n;
+      }
+      return res;
+    }
+
+    /// Replace the numeric literals of some code by sentinels.
+    class Lifter
+    {
+    public:
+      Lifter(const std::string& code)
+        : code_(code)
+        , line_(1)
+        , column_(1)
+      {}
+
+      /// Build the template.  Return false if the literals cannot be
+      /// lifted: there are none, or the code uses constructs whose
+      /// literals must stay as they are (binaries, synclines...), or
+      /// that we do not want to scan (derivatives, \r...).
+      bool
+      operator()()
+      {
+        const char* s = code_.c_str();
+        size_t size = code_.size();
+        if (code_.find('\r') != std::string::npos
+            || code_.find("//#") != std::string::npos
+            || code_.find("BIN") != std::string::npos
+            || code_.find("%unscope:") != std::string::npos)
+          return false;
+        size_t i = 0;
+        while (i < size)
+        {
+          char c = s[i];
+          size_t end = i + 1;
+          if (c == '"' || c == '\'')
+          {
+            // Strings and symbols, but not the suffixes of
+            // derivatives (x', x'n...).
+            if (i && is_id(s[i - 1]))
+              return false;
+            for (; end < size && s[end] != c; ++end)
+              if (s[end] == '\\' && s[++end] == 'B')
+                return false;
+            if (size <= end)
+              return false;
+            ++end;
+          }
+          else if (c == '/' && s[i + 1] == '/')
+          {
+            end = code_.find('\n', i);
+            if (end == std::string::npos)
+              end = size;
+          }
+          else if (c == '/' && s[i + 1] == '*')
+          {
+            // Comments nest.
+            unsigned level = 1;
+            for (end = i + 2; level && end < size; )
+              if (s[end] == '/' && s[end + 1] == '*')
+                ++level, end += 2;
+              else if (s[end] == '*' && s[end + 1] == '/')
+                --level, end += 2;
+              else
+                ++end;
+            if (level)
+              return false;
+          }
+          else if (is_digit(c))
+          {
+            // Numbers which are not alone (durations, hexadecimals,
+            // method calls on numbers...) are left as is.
+            while (end < size && (is_id(s[end]) || s[end] == '.'))
+              ++end;
+            if (number(s + i) == end - i && !(i && s[i - 1] == '.')
+                && lift(i, end - i))
+            {
+              i = end;
+              continue;
+            }
+          }
+          else if (is_id(c))
+            while (end < size && is_id(s[end]))
+              ++end;
+          put(s + i, end - i);
+          i = end;
+        }
+        return !literals.empty();
+      }
+
+      /// The template.
+      std::string tpl;
+      /// The literals, in order.
+      literals_type literals;
+
+    private:
+      /// Replace the literal of length \a n at \a i by a sentinel.
+      bool
+      lift(size_t i, size_t n)
+      {
+        std::string text(code_, i, n);
+        boost::algorithm::erase_all(text, "_");
+        literal l;
+        try
+        {
+          l.value = boost::lexical_cast<ufloat>(text);
+        }
+        catch (const boost::bad_lexical_cast&)
+        {
+          // Let the scanner report the error.
+          return false;
+        }
+        std::string s = sentinel(literals.size());
+        put(s.c_str(), s.size());
+        l.line = line_;
+        l.column = column_;
+        l.delta = int(n) - int(s.size());
+        literals.push_back(l);
+        return true;
+      }
+
+      /// Append \a n characters of \a s to the template.
+      void
+      put(const char* s, size_t n)
+      {
+        tpl.append(s, n);
+        for (size_t i = 0; i < n; ++i)
+          if (s[i] == '\n')
+          {
+            ++line_;
+            column_ = 1;
+          }
+          else
+            ++column_;
+      }
+
+      const std::string& code_;
+      /// The position of the end of the template.
+      unsigned line_;
+      unsigned column_;
+    };
+
+    /// Clone the AST of a template, putting back its literals, and
+    /// the locations of the code.
+    class Instantiator: public ast::Cloner
+    {
+    public:
+      typedef ast::Cloner super_type;
+
+      Instantiator(const literals_type& literals)
+        : super_type(true)
+        , literals_(literals)
+        , found_(literals.size(), false)
+      {}
+
+      /// Whether every literal was put back.
+      bool
+      complete() const
+      {
+        foreach (bool f, found_)
+          if (!f)
+            return false;
+        return true;
+      }
+
+      virtual void
+      operator()(const ast::Ast* e)
+      {
+        super_type::operator()(e);
+        // Relocate the new nodes once, even if they are shared.  The
+        // nodes cloned by reference keep the locations of the
+        // template.
+        if (result_ && result_.get() != e
+            && relocated_.insert(result_.get()).second)
+        {
+          ast::loc l = result_->location_get();
+          relocate(l.begin);
+          relocate(l.end);
+          result_->location_set(l);
+        }
+      }
+
+    protected:
+      using super_type::visit;
+      CONST_VISITOR_VISIT_NODES((Float));
+
+    private:
+      /// Move \a p from the template to the code.
+      void
+      relocate(yy::position& p) const
+      {
+        int column = p.column;
+        foreach (const literal& l, literals_)
+          if (l.line == p.line && l.column <= p.column)
+            column += l.delta;
+        p.column = column;
+      }
+
+      const literals_type& literals_;
+      std::vector<bool> found_;
+      boost::unordered_set<const ast::Ast*> relocated_;
+    };
+
+    void
+    Instantiator::visit(const ast::Float* e)
+    {
+      int k = sentinel_index(e->value_get());
+      if (k < 0)
+        super_type::visit(e);
+      else
+      {
+        found_[k] = true;
+        result_ = new ast::Float(e->location_get(), literals_[k].value);
+      }
+    }
+
+    /// The AST of a template instantiated with \a literals, or 0 if
+    /// the transformations lost some of its sentinels.
+    static ast::rConstAst
+    instantiate(ast::rConstAst tpl, const literals_type& literals)
+    {
+      Instantiator clone(literals);
+      clone(tpl.get());
+      if (!clone.complete())
+        return 0;
+      return clone.result_get();
+    }
+
+
+    /*--------.
+    | Cache.  |
+    `--------*/
+
+    /// An AST, and the code it comes from.
+    struct entry
+    {
+      entry(const std::string& k, ast::rConstAst a)
+        : key(k)
+        , ast(a)
+      {}
+      std::string key;
+      ast::rConstAst ast;
+    };
+
+    /// The entries, most recently used first.
+    typedef std::list<entry> entries_type;
+    static entries_type entries_;
+    typedef boost::unordered_map<std::string, entries_type::iterator>
+      index_type;
+    static index_type index_;
+
+    /// The entry of \a key, made the most recently used, or 0.
+    static entry*
+    find(const std::string& key)
+    {
+      index_type::iterator i = index_.find(key);
+      if (i == index_.end())
+        return 0;
+      entries_.splice(entries_.begin(), entries_, i->second);
+      return &*i->second;
+    }
+
+    /// Add the entry of \a key, and evict the least recently used.
+    static void
+    insert(const std::string& key, ast::rConstAst ast)
+    {
+      entries_.push_front(entry(key, ast));
+      index_[key] = entries_.begin();
+      if (capacity() < entries_.size())
+      {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+      }
+    }
+  }
+
+  ast::rConstAst
+  eval_cache_load(const std::string& code, bool toplevel)
+  {
+    if (!capacity() || max_code_size < code.size())
+      return build(code, toplevel);
+
+    // The code that raises warnings is not cached, so that they are
+    // issued at each evaluation, at the locations of the code: the
+    // templates are parsed quietly.  The keys of the templates start
+    // with "T", those of the code parsed as is with "C", preceded by
+    // "S" for top-level statements.
+    std::string mode = toplevel ? "S" : "";
+    Lifter lift(code);
+    if (parametric() && lift())
+    {
+      std::string key = mode + "T" + lift.tpl;
+      if (entry* e = find(key))
+      {
+        if (e->ast)
+        {
+          ++eval_cache_hits;
+          return instantiate(e->ast, lift.literals);
+        }
+      }
+      else
+      {
+        unsigned long w = warnings;
+        ast::rConstAst tpl;
+        ast::rConstAst res;
+        try
+        {
+          LIBPORT_SCOPE_SET(warnings_quiet, true);
+          tpl = build(lift.tpl, toplevel);
+          res = instantiate(tpl, lift.literals);
+        }
+        catch (const runner::Exception&)
+        {
+          // Report the errors on the code, not on its template.
+        }
+        if (res && w == warnings)
+        {
+          ++eval_cache_misses;
+          insert(key, tpl);
+          return res;
+        }
+        // Remember the templates that cannot be instantiated, or that
+        // issue warnings, to parse their code directly from now on.
+        GD_FINFO_DEBUG("eval cache: cannot lift the literals of %s", code);
+        insert(key, 0);
+      }
+    }
+
+    std::string key = mode + "C" + code;
+    if (entry* e = find(key))
+    {
+      ++eval_cache_hits;
+      return e->ast;
+    }
+    ++eval_cache_misses;
+    unsigned long w = warnings;
+    ast::rConstAst res = build(code, toplevel);
+    if (w == warnings)
+      insert(key, res);
+    return res;
+  }
+}
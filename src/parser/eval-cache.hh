@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file parser/eval-cache.hh
+ ** \brief Cache of the ASTs of the code given to System.eval.
+ */
+
+#ifndef PARSER_EVAL_CACHE_HH
+# define PARSER_EVAL_CACHE_HH
+
+# include <string>
+
+# include <ast/fwd.hh>
+# include <urbi/export.hh>
+
+namespace parser
+{
+  /// Parse and transform (see transform()) \a code, through a cache
+  /// of the ASTs of the code recently evaluated.  If \a toplevel,
+  /// \a code is a single statement of a shell, whose ',' is kept.
+  ///
+  /// The numeric literals are lifted out of the code before looking
+  /// it up, so that "a.val = 12.3" and "a.val = 4.5" share the same
+  /// transformed AST, in which the literals are put back.  The code
+  /// is parsed as is when its literals cannot be lifted.
+  ///
+  /// The cache keeps the URBI_EVAL_CACHE (default 256) most recently
+  /// used ASTs, and is disabled if it is 0.  The lifting of the
+  /// literals is disabled if URBI_EVAL_CACHE_PARAMETRIC is 0.
+  ///
+  /// \throw runner::Exception  on parse errors, as parse() does.
+  URBI_SDK_API ast::rConstAst
+  eval_cache_load(const std::string& code, bool toplevel = false);
+
+  /// The number of calls to eval_cache_load served by the cache.
+  extern URBI_SDK_API unsigned long eval_cache_hits;
+  /// The number of calls to eval_cache_load that parsed the code.
+  extern URBI_SDK_API unsigned long eval_cache_misses;
+
+  /// Reset the hits and misses counters.
+  URBI_SDK_API void eval_cache_stats_reset();
+} // namespace parser
+
+#endif // PARSER_EVAL_CACHE_HH
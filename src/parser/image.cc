@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file parser/image.cc
+ ** \brief Implementation of parser::image_load.
+ */
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <libport/containers.hh>
+#include <libport/cstdio>
+#include <libport/cstdlib>
+#include <libport/debug.hh>
+#include <libport/foreach.hh>
+#include <libport/format.hh>
+#include <libport/unistd.h>
+
+#include <kernel/config.h>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/loc.hh>
+#if defined ENABLE_SERIALIZATION
+# include <ast/serialize.hh>
+#endif
+
+#include <parser/image.hh>
+#include <parser/parse.hh>
+#include <parser/transform.hh>
+
+#include <urbi/package-info.hh>
+
+GD_CATEGORY(Urbi.Parser);
+
+namespace parser
+{
+  std::string
+  image_name(const std::string& file)
+  {
+    return file + "c";
+  }
+
+  namespace
+  {
+    /// Parse and transform \a code, the contents of \a file.
+    static ast::rConstAst
+    build(const std::string& file, const std::string& code)
+    {
+      // Leaks, as in UParser.
+      libport::Symbol* name = new libport::Symbol(file);
+      return transform(ast::rConstExp(parse(code, ast::loc(name))));
+    }
+
+#if defined ENABLE_SERIALIZATION
+    /// 64-bit FNV-1a.
+    static std::string
+    hash(const std::string& s)
+    {
+      unsigned long long res = 14695981039346656037ULL;
+      foreach (unsigned char c, s)
+      {
+        res ^= c;
+        res *= 1099511628211ULL;
+      }
+      return libport::format("%016x", res);
+    }
+
+    /// The first line of the images: the format, and the build of the
+    /// kernel, since the AST changes from one build to another.
+    static const std::string&
+    image_key()
+    {
+      static const std::string res =
+        libport::format("urbi-image 1 %s",
+                        hash(urbi::package_info().signature()));
+      return res;
+    }
+
+    /// The locations are not serialized with the nodes.  They are
+    /// saved apart, in the order of a traversal of the AST, which is
+    /// the same after unserialization.
+    class LocationSaver: public ast::DefaultConstVisitor
+    {
+    public:
+      typedef ast::DefaultConstVisitor super_type;
+
+      virtual void operator()(const ast::Ast* e)
+      {
+        if (e)
+        {
+          locs << e->location_get();
+          super_type::operator()(e);
+        }
+      }
+
+      /// Dump the locations to \a o.
+      void
+      dump(std::ostream& o) const
+      {
+        typedef std::map<const libport::Symbol*, unsigned> files_type;
+        files_type files;
+        std::vector<const libport::Symbol*> names;
+        foreach (const ast::loc& l, locs)
+        {
+          const libport::Symbol* fs[] = { l.begin.filename, l.end.filename };
+          foreach (const libport::Symbol* f, fs)
+            if (f && files.find(f) == files.end())
+            {
+              names << f;
+              files[f] = names.size();
+            }
+        }
+        o << names.size() << std::endl;
+        foreach (const libport::Symbol* f, names)
+          o << *f << std::endl;
+        o << locs.size() << std::endl;
+        foreach (const ast::loc& l, locs)
+          o << (l.begin.filename ? files[l.begin.filename] : 0) << ' '
+            << l.begin.line << ' ' << l.begin.column << ' '
+            << (l.end.filename ? files[l.end.filename] : 0) << ' '
+            << l.end.line << ' ' << l.end.column << std::endl;
+      }
+
+      std::vector<ast::loc> locs;
+    };
+
+    class LocationRestorer: public ast::DefaultVisitor
+    {
+    public:
+      typedef ast::DefaultVisitor super_type;
+
+      /// Load the locations from \a i.
+      /// \return whether they are well formed.
+      bool
+      load(std::istream& i)
+      {
+        size_t nfiles;
+        if (!(i >> nfiles))
+          return false;
+        i.ignore();
+        names_.push_back(0);
+        for (size_t n = 0; n < nfiles; ++n)
+        {
+          std::string name;
+          if (!std::getline(i, name))
+            return false;
+          // Leaks, as in UParser.
+          names_.push_back(new libport::Symbol(name));
+        }
+        size_t nlocs;
+        if (!(i >> nlocs))
+          return false;
+        locs_.reserve(nlocs);
+        for (size_t n = 0; n < nlocs; ++n)
+        {
+          size_t bf, ef;
+          ast::loc l;
+          if (!(i >> bf >> l.begin.line >> l.begin.column
+                >> ef >> l.end.line >> l.end.column)
+              || nfiles < bf || nfiles < ef)
+            return false;
+          l.begin.filename = names_[bf];
+          l.end.filename = names_[ef];
+          locs_ << l;
+        }
+        i.ignore();
+        return true;
+      }
+
+      virtual void operator()(ast::Ast* e)
+      {
+        if (e)
+        {
+          if (next_ == locs_.size())
+            throw std::runtime_error("invalid image locations");
+          e->location_set(locs_[next_++]);
+          super_type::operator()(e);
+        }
+      }
+
+      /// Whether all the locations were used.
+      bool
+      complete() const
+      {
+        return next_ == locs_.size();
+      }
+
+      LocationRestorer()
+        : next_(0)
+      {}
+
+    private:
+      std::vector<libport::Symbol*> names_;
+      std::vector<ast::loc> locs_;
+      size_t next_;
+    };
+
+    /// Read the image \a image, built from contents whose hash is \a h.
+    /// \return 0 if it is missing, stale, or invalid.
+    static ast::rAst
+    read_image(const std::string& image, const std::string& h)
+    {
+      std::ifstream is(image.c_str(), std::ios::binary);
+      if (!is)
+        return 0;
+      std::string key, content;
+      if (!std::getline(is, key) || key != image_key()
+          || !std::getline(is, content) || content != h)
+      {
+        GD_FINFO_TRACE("stale image: %s", image);
+        return 0;
+      }
+      try
+      {
+        LocationRestorer restorer;
+        if (!restorer.load(is))
+          return 0;
+        ast::rAst res = ast::unserialize(is);
+        restorer(res.get());
+        if (restorer.complete())
+          return res;
+      }
+      catch (const std::exception& e)
+      {
+        GD_FWARN("invalid image: %s: %s", image, e.what());
+      }
+      return 0;
+    }
+
+    /// Save \a ast, built from contents whose hash is \a h, as \a image.
+    /// Failures are not errors: the image is just missing.
+    static void
+    write_image(const std::string& image, const std::string& h,
+                ast::rConstAst ast)
+    {
+      // Write under a temporary name, so that concurrent kernels do not
+      // read an incomplete image.
+      std::string tmp = libport::format("%s.%s", image, getpid());
+      {
+        std::ofstream os(tmp.c_str(), std::ios::binary);
+        if (!os)
+        {
+          GD_FINFO_TRACE("cannot create image: %s", image);
+          return;
+        }
+        os << image_key() << std::endl
+           << h << std::endl;
+        LocationSaver saver;
+        saver(ast.get());
+        saver.dump(os);
+        ast::serialize(ast, os);
+        if (!os)
+        {
+          os.close();
+          unlink(tmp.c_str());
+          return;
+        }
+      }
+      if (rename(tmp.c_str(), image.c_str()))
+        unlink(tmp.c_str());
+      else
+        GD_FINFO_TRACE("saved image: %s", image);
+    }
+
+    /// Whether URBI_IMAGES does not disable the images.
+    static bool
+    images_enabled()
+    {
+      static bool res = !getenv("URBI_IMAGES")
+        || std::string(getenv("URBI_IMAGES")) != "0";
+      return res;
+    }
+#endif
+  }
+
+  ast::rConstAst
+  image_load(const std::string& file, bool use_image, bool* from_image)
+  {
+    if (from_image)
+      *from_image = false;
+    std::ifstream is(file.c_str());
+    if (!is)
+      return transform(ast::rConstExp(parse_file(file)));
+    std::string code;
+    {
+      std::stringstream s;
+      s << is.rdbuf();
+      code = s.str();
+    }
+#if defined ENABLE_SERIALIZATION
+    if (use_image && images_enabled())
+    {
+      std::string image = image_name(file);
+      std::string h = hash(code);
+      if (ast::rAst res = read_image(image, h))
+      {
+        if (from_image)
+          *from_image = true;
+        return res;
+      }
+      ast::rConstAst res = build(file, code);
+      write_image(image, h, res);
+      return res;
+    }
+#else
+    LIBPORT_USE(use_image);
+#endif
+    return build(file, code);
+  }
+} // namespace parser
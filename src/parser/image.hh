@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2012, Gostai S.A.S.
+ *
+ * This software is provided "as is" without warranty of any kind,
+ * either expressed or implied, including but not limited to the
+ * implied warranties of fitness for a particular purpose.
+ *
+ * See the LICENSE file for more information.
+ */
+
+/**
+ ** \file parser/image.hh
+ ** \brief Precompiled images of urbiscript files.
+ */
+
+#ifndef PARSER_IMAGE_HH
+# define PARSER_IMAGE_HH
+
+# include <string>
+
+# include <ast/fwd.hh>
+# include <urbi/export.hh>
+
+namespace parser
+{
+  /// Parse and transform (see transform()) the file \a file.
+  ///
+  /// If \a use_image, the result is read from the image of the file,
+  /// FILE.uc, when it was built by this kernel from the same contents.
+  /// Otherwise the file is parsed, and its image is (re)built if
+  /// possible.  Images are not used if the kernel was built without
+  /// serialization support, or if URBI_IMAGES is set to 0.
+  ///
+  /// \param from_image  if nonnull, set to whether the image was used.
+  URBI_SDK_API ast::rConstAst
+  image_load(const std::string& file, bool use_image,
+             bool* from_image = 0);
+
+  /// The name of the image of \a file.
+  URBI_SDK_API std::string
+  image_name(const std::string& file);
+} // namespace parser
+
+#endif // PARSER_IMAGE_HH
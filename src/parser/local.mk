@@ -7,7 +7,11 @@
 ## See the LICENSE file for more information.
 
 dist_libuobject@LIBSFX@_la_SOURCES +=		\
+  parser/eval-cache.hh				\
+  parser/eval-cache.cc				\
   parser/fwd.hh					\
+  parser/image.hh				\
+  parser/image.cc				\
   parser/is-keyword.hh				\
   parser/is-keyword.cc				\
   parser/metavar-map.hh				\
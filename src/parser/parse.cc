@@ -25,6 +25,9 @@
 
 namespace parser
 {
+  unsigned long warnings = 0;
+  bool warnings_quiet = false;
+
   namespace
   {
     static
@@ -37,6 +37,10 @@ namespace parser
   parse_result_type URBI_SDK_API
   parse_file(const std::string& file);
 
+  /// The number of warnings issued by the parsers so far.
+  extern URBI_SDK_API unsigned long warnings;
+  /// Whether the warnings are only counted, not reported.
+  extern URBI_SDK_API bool warnings_quiet;
 }
 
 #endif // !PARSER_PARSE_HH
@@ -28,6 +28,7 @@
 #include <ast/nary.hh>
 #include <ast/print.hh>
 
+#include <parser/parse.hh>
 #include <parser/parser-impl.hh>
 #include <parser/parser-utils.hh>
 #include <parser/utoken.hh>
@@ -146,7 +147,9 @@ namespace parser
   void
   ParserImpl::warn(const location_type& l, const std::string& msg)
   {
-    errors_.warn(l, msg);
+    ++warnings;
+    if (!warnings_quiet)
+      errors_.warn(l, msg);
   }
 
   void
@@ -233,8 +233,9 @@ namespace rewrite
       new ast::Routine(cond_loc, true, new ast::local_declarations_type,
                        factory_->make_scope(cond_loc, at->cond_get()));
 
-    ast::EventMatch match(new ast::Event(cond_loc, closure),
-                          0, at->duration_get(), 0);
+    ast::rEvent event = new ast::Event(cond_loc, closure);
+    event->coalesce_set(at->coalesce_get());
+    ast::EventMatch match(event, 0, at->duration_get(), 0);
     result_ =
       factory_->make_at_event(loc,
                               at->flavor_location_get(), at->flavor_get(),
@@ -29,6 +29,7 @@
 #include <urbi/kernel/uconnection.hh>
 #include <kernel/uobject.hh>
 #include <urbi/kernel/userver.hh>
+#include <parser/eval-cache.hh>
 #include <parser/transform.hh>
 #include <parser/uparser.hh>
 #include <runner/exception.hh>
@@ -256,6 +257,8 @@ namespace runner
           assert(parser_);
           res = parser_->parse();
         }
+        // No eval cache here: the parser reads the stream itself, the
+        // text of a command is known only once it is parsed.
         ast::rExp ast = parser::transform(ast::rConstExp(res));
         handle_command_(ast);
         handle_command_end_();
@@ -297,13 +300,11 @@ namespace runner
         if (!code.empty())
         {
           // We must parse and execute synchronously, but honor ',': this is
-          // toplevel code.
-          yy::location loc;
-          parser::UParser p(code, &loc);
-          p.oneshot_set(false);
-          ast::rConstExp e = p.parse();
-          ast::rConstExp ast = parser::transform(e);
-          handle_command_(ast::rConstExp(ast), false);
+          // toplevel code.  Remote UObjects send the same calls over
+          // and over, with different arguments: use the eval cache.
+          ast::rConstExp ast =
+            parser::eval_cache_load(code, true).unsafe_cast<const ast::Exp>();
+          handle_command_(ast, false);
         }
         handle_command_end_();
       }
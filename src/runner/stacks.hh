@@ -31,11 +31,26 @@ namespace runner
     typedef object::rObject rObject;
     typedef object::rSlot   rSlot;
 
-    /// Type of a stack frame.
-    typedef std::pair<rSlot*, rSlot*> frame_type;
+    /// A local variable.  Its value is stored inline, and promoted to
+    /// a Slot only when one is required: to be shared with a closure
+    /// or a lazy argument capturing it, to access its properties, or
+    /// to be constant.  Once promoted, the variable lives in the slot.
+    struct local_type
+    {
+      local_type(rObject v = 0)
+        : value(v)
+        , slot()
+      {}
+      rObject value;
+      rSlot slot;
+    };
+
+    /// Type of a stack frame: the local variables, and the captured
+    /// variables.
+    typedef std::pair<local_type*, rSlot*> frame_type;
 
     /// Type of the toplevel variable stack.
-    typedef std::vector<rSlot> toplevel_stack_type;
+    typedef std::vector<local_type> toplevel_stack_type;
 
     /// Type of a context.
     struct context_type
@@ -110,6 +125,8 @@ namespace runner
     /// Factored helpers for both rget.
     Stacks::rSlot
     rget(libport::Symbol name, unsigned index, unsigned depth);
+    /// The slot of \a l, promoting it if needed.
+    static rSlot promote(local_type& l);
 
   /*-----------------.
   | Setting values.  |
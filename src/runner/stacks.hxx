@@ -31,10 +31,10 @@ namespace runner
   LIBPORT_SPEED_ALWAYS_INLINE
   Stacks::Stacks(rObject self)
     : toplevel_stack_()
-    , current_frame_((rSlot*)0, (rSlot*)0)
+    , current_frame_((local_type*)0, (rSlot*)0)
     , depth_(0)
   {
-    toplevel_stack_ << new Slot(self) << new Slot;
+    toplevel_stack_ << local_type(self) << local_type();
     current_frame_.first = &toplevel_stack_[0];
     current_frame_.second = 0;
   }
@@ -46,7 +46,7 @@ namespace runner
   {
     context_type res(toplevel_stack_, current_frame_, depth_);
     toplevel_stack_.clear();
-    toplevel_stack_ << new Slot(self) << new Slot;
+    toplevel_stack_ << local_type(self) << local_type();
     current_frame_.first = &toplevel_stack_[0];
     current_frame_.second = 0;
     depth_ = 0;
@@ -75,8 +75,8 @@ namespace runner
     current_frame_ = frame;
 
     // Bind 'this' and 'call'.
-    current_frame_.first[0] = new Slot(self);
-    current_frame_.first[1] = new Slot(call);
+    current_frame_.first[0].value = self;
+    current_frame_.first[1].value = call;
     ++depth_;
 
     // Return previous frame.
@@ -87,28 +87,28 @@ namespace runner
   void
   Stacks::this_set(rObject s)
   {
-    *current_frame_.first[0] = s;
+    current_frame_.first[0].value = s;
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
   void
   Stacks::call_set(rObject v)
   {
-    *current_frame_.first[1] = v;
+    current_frame_.first[1].value = v;
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
   Stacks::rObject
   Stacks::this_get()
   {
-    return current_frame_.first[0]->value();
+    return current_frame_.first[0].value;
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
   Stacks::rObject
   Stacks::call()
   {
-    return current_frame_.first[1]->value();
+    return current_frame_.first[1].value;
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
@@ -135,7 +135,13 @@ namespace runner
     if (captured)
       *current_frame_.second[local] = v;
     else
-      *current_frame_.first[local + 2] = v;
+    {
+      local_type& l = current_frame_.first[local + 2];
+      if (l.slot)
+        *l.slot = v;
+      else
+        l.value = v;
+    }
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
@@ -151,7 +157,7 @@ namespace runner
       if (size >= toplevel_stack_.size())
       {
         for (unsigned i = toplevel_stack_.size(); i <= size; ++i)
-          toplevel_stack_ << rSlot();
+          toplevel_stack_ << local_type();
       }
       current_frame_.first = &toplevel_stack_[0];
     }
@@ -160,12 +166,14 @@ namespace runner
       assert(v->as<Slot>());
       def(e->local_index_get() + 2, false, v->as<Slot>());
     }
-    else
+    else if (constant)
     {
       rSlot slot = new Slot(v);
-      slot->constant_set(constant);
+      slot->constant_set(true);
       def(e->local_index_get() + 2, false, slot);
     }
+    else
+      def(e->local_index_get() + 2, v);
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
@@ -190,14 +198,32 @@ namespace runner
     if (captured)
       current_frame_.second[local] = v;
     else
-      current_frame_.first[local] = v;
+    {
+      current_frame_.first[local].value = 0;
+      current_frame_.first[local].slot = v;
+    }
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
   void
   Stacks::def(unsigned local, rObject v)
   {
-    def(local, false, new Slot(v));
+    // A fresh variable: forget the slot a previous incarnation may
+    // have been promoted to, it belongs to its captors now.
+    current_frame_.first[local].value = v;
+    current_frame_.first[local].slot = 0;
+  }
+
+  LIBPORT_SPEED_ALWAYS_INLINE
+  Stacks::rSlot
+  Stacks::promote(local_type& l)
+  {
+    if (!l.slot)
+    {
+      l.slot = l.value ? new Slot(l.value) : new Slot;
+      l.value = 0;
+    }
+    return l.slot;
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
@@ -207,7 +233,7 @@ namespace runner
     if (depth)
       return current_frame_.second[index];
     else
-      return current_frame_.first[index + 2];
+      return promote(current_frame_.first[index + 2]);
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
@@ -227,7 +253,10 @@ namespace runner
   LIBPORT_SPEED_ALWAYS_INLINE
   Stacks::rObject Stacks::get(ast::rConstLocal e)
   {
-    return rget(e)->value();
+    if (e->depth_get())
+      return current_frame_.second[e->local_index_get()]->value();
+    const local_type& l = current_frame_.first[e->local_index_get() + 2];
+    return l.slot ? l.slot->value() : l.value;
   }
 
   LIBPORT_SPEED_ALWAYS_INLINE
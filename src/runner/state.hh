@@ -197,6 +197,9 @@ namespace runner
     /// Type of a stack frame.
     typedef Stacks::frame_type var_frame_type;
 
+    /// Type of a local variable in a stack frame.
+    typedef Stacks::local_type var_local_type;
+
     /// Type of a context.
     typedef Stacks::context_type var_context_type;
 
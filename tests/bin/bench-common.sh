@@ -0,0 +1,62 @@
+# Run the benches of tests/benches on a build tree, as uconsole would.
+# Sourced by bench-engines and bench-slots, which define $srcdir (the
+# tests directory), $runs and $tmp.
+
+# directive_get DIRECTIVE FILE...
+# -------------------------------
+# The values of the //#DIRECTIVE lines of the FILEs, 1 for those
+# without value (see kernel-check.m4sh).
+directive_get ()
+{
+  local directive="$1"
+  shift
+  sed -n -e "s,^//#$directive\$,1,p"            \
+         -e "s,^//#$directive:* *,,p"           \
+         "$@"
+}
+
+# bench_input BENCH
+# -----------------
+# Create $tmp/BENCH.u: the input of BENCH, without the expected
+# output, and making sure the kernel exits.
+bench_input ()
+{
+  grep -v '^\[[0-9]*' "$srcdir/benches/$1.chk" >"$tmp/$1.u"
+  echo 'shutdown;' >>"$tmp/$1.u"
+}
+
+# run BUILDDIR BENCH [FLAG...]
+# ----------------------------
+# Output the best wall clock time over $runs runs of BENCH by the
+# kernel of BUILDDIR, with FLAGs, in seconds.  Honor the //#plug and
+# //#no-fast directives of BENCH.
+run ()
+{
+  local build=$1
+  local bench=$2
+  shift 2
+  local chk="$srcdir/benches/$bench.chk"
+  local plugs=$(directive_get plug "$chk" | sed -e 's/\.[0-9][0-9]*$//')
+  test -n "$(directive_get no-fast "$chk")" ||
+    set -- "$@" --fast
+  set -- "$@" --quiet -f "$tmp/$bench.u"
+  if test -n "$plugs"; then
+    set -- "$build/sdk-remote/src/tests/bin/urbi-launch" \
+      --start $plugs -- "$@"
+  else
+    set -- "$build/tests/bin/urbi" "$@"
+  fi
+
+  local best=
+  local i start t
+  for i in $(seq $runs)
+  do
+    start=$(date +%s.%N)
+    "$@" >/dev/null 2>&1
+    t=$(echo "$(date +%s.%N) - $start" | bc)
+    if test -z "$best" || test $(echo "$t < $best" | bc) = 1; then
+      best=$t
+    fi
+  done
+  printf '%.3f' $best
+}